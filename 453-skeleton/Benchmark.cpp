@@ -0,0 +1,166 @@
+#include "Benchmark.h"
+
+#include "ComputeFractals.h"
+#include "FeedbackFractals.h"
+#include "Log.h"
+#include "RandomAccessFractals.h"
+#include "TaskPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+	// Best wall clock time of repetitions runs of job, in seconds. glFinish makes sure the
+	// GPU has finished the work before the clock stops
+	template <typename Job>
+	double bestTime(int repetitions, Job job) {
+		double best = std::numeric_limits<double>::max();
+		for (int i = 0; i < repetitions; i++) {
+			auto start = std::chrono::steady_clock::now();
+			job();
+			glFinish();
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			best = std::min(best, elapsed.count());
+		}
+		return best;
+	}
+
+	std::string describe(const std::string& name, double seconds, std::size_t vertexCount) {
+		return fmt::format("{} {:9.3f} ms {:8.1f} Mvert/s", name, seconds * 1e3, vertexCount / seconds * 1e-6);
+	}
+
+	// Level of each primitive the recursive generators emit when they keep every level (the tree),
+	// children before their parent
+	void primitiveLevels(int iteration, int branching, int level, std::vector<int>& levels) {
+		if (level < iteration) {
+			for (int child = 0; child < branching; child++) {
+				primitiveLevels(iteration, branching, level + 1, levels);
+			}
+		}
+		levels.push_back(level);
+	}
+
+	// Largest distance between the positions or colours of the vertexCount vertices a GPU generator
+	// wrote into gpuGeom and those of the recursive generator in reference, taken deepest level first
+	// when the scene keeps every level (the tree). Infinite if the numbers of vertices differ
+	float gpuDifference(const FractalRequest& request, const GPU_Geometry& gpuGeom, GLsizei vertexCount, const CPU_Geometry& reference) {
+		CPU_Geometry written;
+		gpuGeom.download(vertexCount, written);
+		for (const Vertex& vertex : written.vertices) {
+			written.verts.push_back(vertex.position);
+			written.cols.push_back(vertex.colour);
+		}
+		if (written.verts.size() != reference.verts.size()) {
+			return std::numeric_limits<float>::infinity();
+		}
+
+		const Scene& scene = fractalScene(request.sceneNumber);
+		std::size_t corners = std::size_t(scene.corners);
+		std::vector<std::size_t> primitives(reference.verts.size() / corners);
+		std::iota(primitives.begin(), primitives.end(), std::size_t(0));
+		if (scene.allLevels) {
+			std::vector<int> levels;
+			primitiveLevels(request.iteration, scene.branching, 0, levels);
+			std::stable_sort(primitives.begin(), primitives.end(), [&](std::size_t a, std::size_t b) {
+				return levels[a] > levels[b];
+			});
+		}
+
+		float largest = 0.f;
+		for (std::size_t i = 0; i < written.verts.size(); i++) {
+			std::size_t expected = primitives[i / corners] * corners + i % corners;
+			largest = std::max({ largest,
+				glm::length(written.verts[i] - reference.verts[expected]),
+				glm::length(written.cols[i] - reference.cols[expected]) });
+		}
+		return largest;
+	}
+
+	// Float rounding on the GPU differs, but never by this much
+	constexpr float GPU_TOLERANCE = 1e-4f;
+}
+
+
+void runGenerationBenchmark(GeneratorType generator, VertexLayout layout, int repetitions) {
+	GPU_Geometry gpuGeom(layout);
+	GPU_MappedGeometry mappedGeom(layout);
+	CPU_Geometry cpuGeom;
+	CPU_Geometry reference; // Of the recursive generator
+	CPU_Geometry randomAccess; // Every primitive computed on its own
+	TaskPool pool;
+	GenerationArena arena;
+	GenerationContext context;
+	context.pool = &pool;
+	context.arena = &arena;
+	context.format.layout = layout;
+
+	FeedbackGenerator feedbackGenerator(layout);
+#ifdef USE_OPENGL_4_6
+	ComputeGenerator computeGenerator(layout);
+#endif
+
+	for (int sceneNumber = 0; sceneNumber < SCENE_COUNT; sceneNumber++) {
+		const char* name = fractalScene(sceneNumber).name;
+		for (int iteration = 0; iteration <= fractalMaxIterations(sceneNumber); iteration++) {
+			FractalRequest request{ sceneNumber, iteration };
+
+			// The CPU generators only count once the geometry is on the GPU, like the others
+			double cpu = bestTime(repetitions, [&]() {
+				generateFractal(request, cpuGeom, generator, context);
+				gpuGeom.upload(cpuGeom);
+			});
+			std::size_t vertexCount = countVertices(cpuGeom, layout);
+			std::string line = describe("cpu", cpu, vertexCount);
+
+			// Written straight into the mapped buffers by the iterative generator, whatever generator is set
+			double mapped = bestTime(repetitions, [&]() {
+				generateFractal(request, mappedGeom.map(vertexCount));
+				mappedGeom.unmap();
+			});
+			line += " | " + describe("mapped", mapped, vertexCount);
+
+			// Computing every primitive on its own has to give the output of the recursive generator exactly
+			generateFractal(request, reference);
+			std::size_t primitiveCount = fractalPrimitiveCount(request);
+			std::size_t primitiveSize = reference.verts.size() / primitiveCount;
+			randomAccess.verts.resize(reference.verts.size());
+			randomAccess.cols.resize(reference.cols.size());
+			double random = bestTime(repetitions, [&]() {
+				generateFractalRange(request, 0, primitiveCount, randomAccess.verts.data(), randomAccess.cols.data());
+			});
+			line += " | " + describe("random", random, primitiveCount * primitiveSize);
+			if (randomAccess.verts != reference.verts || randomAccess.cols != reference.cols) {
+				Log::warn("{} iteration {}: the random access generator differs from the recursive one", name, iteration);
+			}
+
+			GLsizei feedbackCount = 0;
+			double feedback = bestTime(repetitions, [&]() { feedbackCount = feedbackGenerator.generate(request, gpuGeom); });
+			line += " | " + describe("feedback", feedback, vertexCount);
+			float feedbackDifference = gpuDifference(request, gpuGeom, feedbackCount, reference);
+			if (!(feedbackDifference <= GPU_TOLERANCE)) {
+				Log::warn("{} iteration {}: the feedback generator differs from the recursive one by {}", name, iteration, feedbackDifference);
+			}
+#ifdef USE_OPENGL_4_6
+			GLsizei computeCount = 0;
+			double compute = bestTime(repetitions, [&]() { computeCount = computeGenerator.generate(request, gpuGeom); });
+			line += " | " + describe("compute", compute, vertexCount);
+			float computeDifference = gpuDifference(request, gpuGeom, computeCount, reference);
+			if (!(computeDifference <= GPU_TOLERANCE)) {
+				Log::warn("{} iteration {}: the compute generator differs from the recursive one by {}", name, iteration, computeDifference);
+			}
+			if (computeGenerator.drawCount() != computeCount) {
+				Log::warn("{} iteration {}: the compute generator wrote a draw count of {} for {} vertices", name, iteration, computeGenerator.drawCount(), computeCount);
+			}
+#endif
+
+			Log::info("{:19} iteration {:2} {:8} vertices: {}", name, iteration, vertexCount, line);
+		}
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a benchmark of the generators that can fill a GPU_Geometry:
+// a CPU generator followed by an upload, the iterative generator writing into a
+// GPU_MappedGeometry, the FeedbackGenerator and, when built with USE_OPENGL_4_6,
+// the ComputeGenerator. The random access generator is timed as well, and checked
+// against the recursive one. Run it with --benchmark, it works under Mesa's
+// software driver (LIBGL_ALWAYS_SOFTWARE=1) too.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+
+// Logs the best of repetitions times of every generator for every scene and iteration, and the
+// resulting vertices per second. Warns if the random access output differs from the recursive
+// output. Needs a current OpenGL context.
+// Throws std::runtime_error for VertexLayout::Packed, which the GPU generators cannot write
+void runGenerationBenchmark(GeneratorType generator, VertexLayout layout, int repetitions);
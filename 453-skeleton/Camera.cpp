@@ -0,0 +1,45 @@
+#include "Camera.h"
+
+#include <algorithm>
+
+
+void Camera::pan(const glm::dvec2& from, const glm::dvec2& to, const glm::ivec2& windowSize) {
+	centre += toFigure(from, windowSize) - toFigure(to, windowSize);
+}
+
+
+void Camera::zoomAt(const glm::dvec2& cursor, double factor, const glm::ivec2& windowSize) {
+	glm::dvec2 anchor = toFigure(cursor, windowSize);
+	zoom = std::clamp(zoom * factor, 1.0, MAX_CAMERA_ZOOM);
+	centre += anchor - toFigure(cursor, windowSize); // Put the anchor back under the cursor
+}
+
+
+void Camera::reset() {
+	centre = glm::dvec2(0.0);
+	zoom = 1.0;
+}
+
+
+glm::dvec2 Camera::toFigure(const glm::dvec2& cursor, const glm::ivec2& windowSize) const {
+	glm::dvec2 ndc(2.0 * cursor.x / windowSize.x - 1.0, 1.0 - 2.0 * cursor.y / windowSize.y);
+	return centre + ndc / zoom;
+}
+
+
+ViewRegion Camera::view(const glm::ivec2& windowSize) const {
+	ViewRegion region;
+	region.min = centre - 1.0 / zoom;
+	region.max = centre + 1.0 / zoom;
+	region.pixelSize = 2.0 / (zoom * std::max(windowSize.x, windowSize.y));
+	region.origin = centre;
+	return region;
+}
+
+
+void Camera::setUniforms(GLuint program, const glm::dvec2& origin) const {
+	glm::dvec2 offset = centre - origin;
+	glUseProgram(program);
+	glUniform2f(glGetUniformLocation(program, "viewCentre"), float(offset.x), float(offset.y));
+	glUniform1f(glGetUniformLocation(program, "viewScale"), float(zoom));
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a 2D camera for panning around and zooming into the
+// fractals. basic.vert applies it, and its ViewRegion lets the culling
+// generators (see CulledFractals.h) skip what is off screen or too small to see
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+
+// Deepest zoom, 2^32. The figures are generated relative to the centre of the view, so float
+// positions are not what limits it. Around here the Sierpinski Triangle runs out of iterations
+// (MAX_FRACTAL_DEPTH), and deeper its smallest triangles would just grow
+constexpr double MAX_CAMERA_ZOOM = 4294967296.0;
+
+
+// Shows the square centre +- 1 / zoom of the figures (which lie in [-1, 1]) across the window.
+// Cursor positions are in window coordinates, as GLFW reports them (y down)
+class Camera {
+public:
+	// Moves the view so the point under from ends up under to
+	void pan(const glm::dvec2& from, const glm::dvec2& to, const glm::ivec2& windowSize);
+
+	// Zooms in by factor (out, below 1), keeping the point under the cursor where it is
+	void zoomAt(const glm::dvec2& cursor, double factor, const glm::ivec2& windowSize);
+
+	void reset();
+
+	// Point of the figures under a cursor position
+	glm::dvec2 toFigure(const glm::dvec2& cursor, const glm::ivec2& windowSize) const;
+
+	// What the window shows, for the culling generators. Its origin is the centre of the view
+	ViewRegion view(const glm::ivec2& windowSize) const;
+
+	// Puts viewCentre and viewScale into the uniforms of a program using basic.vert (which is left in use),
+	// for vertices relative to origin. The difference is taken in double, so it stays precise
+	void setUniforms(GLuint program, const glm::dvec2& origin = glm::dvec2(0.0)) const;
+
+private:
+	glm::dvec2 centre = glm::dvec2(0.0);
+	double zoom = 1.0;
+};
@@ -0,0 +1,179 @@
+#include "CodedFractals.h"
+
+#include <array>
+#include <stdexcept>
+
+
+namespace {
+
+	void prepare(CPU_Geometry& cpuGeom, std::size_t leafCount, std::size_t vertexCount) {
+		if (leafCount > (std::size_t(1) << COLOUR_CODE_PATH_BITS)) {
+			throw std::runtime_error("Too many iterations for colour codes.");
+		}
+		cpuGeom.verts.clear();
+		cpuGeom.cols.clear();
+		cpuGeom.codedVertices.clear();
+		cpuGeom.codedVertices.reserve(vertexCount);
+	}
+
+	void checkSize(const ColourTable& colourTable) {
+		if (colourTable.steps.size() > MAX_COLOUR_STEPS) {
+			throw std::runtime_error("Too many iterations for the colour table.");
+		}
+	}
+
+	void addSierpinski(const SierpinskiTriangle& triangle, int iteration, int totalIterations, int depth, std::uint32_t path, std::vector<CodedVertex>& codedVertices, const std::atomic<bool>* cancelled) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		if (iteration > 0) {
+			std::uint32_t child = 0;
+			for (const SierpinskiTriangle& next : triangle.subdivide(iteration, totalIterations)) {
+				addSierpinski(next, iteration - 1, totalIterations, depth + 1, path * 3 + child++, codedVertices, cancelled);
+			}
+		}
+		else {
+			GLuint code = colourCode(depth, path, 0);
+			codedVertices.push_back({ glm::vec2(triangle.A), code }); // Lower Left
+			codedVertices.push_back({ glm::vec2(triangle.B), code }); // Lower Right
+			codedVertices.push_back({ glm::vec2(triangle.C), code }); // Upper
+		}
+	}
+
+	void addLevy(const LevyCCurve& line, int iteration, int totalIterations, int depth, std::uint32_t path, std::vector<CodedVertex>& codedVertices, const std::atomic<bool>* cancelled) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		if (iteration > 0) {
+			std::uint32_t child = 0;
+			for (const LevyCCurve& next : line.subdivide(iteration, totalIterations)) {
+				addLevy(next, iteration - 1, totalIterations, depth + 1, path * 2 + child++, codedVertices, cancelled);
+			}
+		}
+		else {
+			codedVertices.push_back({ glm::vec2(line.A), colourCode(depth, path, 0) }); // Left point
+			codedVertices.push_back({ glm::vec2(line.B), colourCode(depth, path, 1) }); // Right point
+		}
+	}
+
+	void addTree(const Tree& branch, int iteration, int iterationCounter, int depth, std::uint32_t path, std::vector<CodedVertex>& codedVertices, const std::atomic<bool>* cancelled) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		if (iteration > 0) {
+			iterationCounter++;
+			std::uint32_t child = 0;
+			for (const Tree& next : branch.grow(iterationCounter)) {
+				addTree(next, iteration - 1, iterationCounter, depth + 1, path * 3 + child++, codedVertices, cancelled);
+			}
+		}
+
+		// The branch comes after its children, like in treeCreate
+		codedVertices.push_back({ glm::vec2(branch.base), colourCode(depth, path, 0) }); // Left point
+		codedVertices.push_back({ glm::vec2(branch.top), colourCode(depth, path, 1) }); // Right point
+	}
+}
+
+
+void sierpinskiColourTable(const SierpinskiTriangle& triangle, int iteration, int totalIterations, ColourTable& colourTable) {
+	colourTable.branching = 3;
+	colourTable.baseColours[0] = triangle.colour;
+	colourTable.baseColours[1] = triangle.colour;
+	colourTable.steps.clear();
+
+	// Every child adds its own increment to the colour of its parent
+	for (int level = 0; level < iteration; level++) {
+		for (const SierpinskiTriangle& child : triangle.subdivide(iteration - level, totalIterations)) {
+			colourTable.steps.push_back({ { 0.f, 1.f }, child.colour - triangle.colour, glm::vec4(0.f) });
+		}
+	}
+}
+
+
+void levyColourTable(const LevyCCurve& line, int iteration, int totalIterations, ColourTable& colourTable) {
+	colourTable.branching = 2;
+	colourTable.baseColours[0] = line.colourA;
+	colourTable.baseColours[1] = line.colourB;
+	colourTable.steps.clear();
+
+	// The new vertex mixes the colours at the ends of its parent
+	for (int level = 0; level < iteration; level++) {
+		int remaining = iteration - level;
+		float colourMidpoint = (static_cast<float>(totalIterations) - remaining) / totalIterations; // As in LevyCCurve::subdivide
+		colourTable.steps.push_back({ { 0.f, colourMidpoint }, glm::vec3(0.f), glm::vec4(0.f) });
+		colourTable.steps.push_back({ { colourMidpoint, 1.f }, glm::vec3(0.f), glm::vec4(0.f) });
+	}
+}
+
+
+void treeColourTable(const Tree& branch, int iteration, int iterationCounter, ColourTable& colourTable) {
+	colourTable.branching = 3;
+	colourTable.baseColours[0] = branch.colour;
+	colourTable.baseColours[1] = branch.colour;
+	colourTable.steps.clear();
+
+	// A branch has the trunk colour until the leaves start, after which it has the leaf colour
+	// whatever its parent was, so growing the trunk tells the colour of every level
+	for (int level = 0; level < iteration; level++) {
+		for (const Tree& child : branch.grow(iterationCounter + level + 1)) {
+			colourTable.steps.push_back({ { 0.f, 1.f }, glm::vec3(0.f), glm::vec4(child.colour, 1.f) });
+		}
+	}
+}
+
+
+/*
+* Creates coded vertices for Sierpinski Triangle
+*
+* @param triangle	Initial triangle
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param cpuGeom	Collection of vectors for geometry
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+void sierpinskiTriangleCreateCoded(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	prepare(cpuGeom, sierpinskiTriangleCount(iteration), 3 * sierpinskiTriangleCount(iteration));
+	sierpinskiColourTable(triangle, iteration, totalIterations, cpuGeom.colourTable);
+	checkSize(cpuGeom.colourTable);
+	addSierpinski(triangle, iteration, totalIterations, 0, 0, cpuGeom.codedVertices, cancelled);
+}
+
+
+/*
+* Creates coded vertices for Levy C Curve
+*
+* @param line	Initial line
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param cpuGeom	Collection of vectors for geometry
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+void levyCCurveCreateCoded(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	prepare(cpuGeom, levySegmentCount(iteration), 2 * levySegmentCount(iteration));
+	levyColourTable(line, iteration, totalIterations, cpuGeom.colourTable);
+	checkSize(cpuGeom.colourTable);
+	addLevy(line, iteration, totalIterations, 0, 0, cpuGeom.codedVertices, cancelled);
+}
+
+
+/*
+* Creates coded vertices for Tree scene
+*
+* @param branch		Tree trunk
+* @param iteration	Number of iterations to generate
+* @param iterationCounter	tracks number of iterations completed to detect when to start creating leaves
+* @param cpuGeom	Collection of vectors for geometry
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+void treeCreateCoded(const Tree& branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	prepare(cpuGeom, sierpinskiTriangleCount(iteration), 2 * treeBranchCount(iteration));
+	treeColourTable(branch, iteration, iterationCounter, cpuGeom.colourTable);
+	checkSize(cpuGeom.colourTable);
+	addTree(branch, iteration, iterationCounter, 0, 0, cpuGeom.codedVertices, cancelled);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains generators that write a colour code per vertex instead of
+// a colour.
+//
+// The colours of all three scenes follow from the path down the recursion: the
+// Sierpinski Triangle adds an increment per level that depends on the child
+// taken, the Levy C Curve mixes the colours at the ends of its parent, and the
+// tree switches to the leaf colour past a fixed depth. So each vertex stores
+// its depth, path and end (see CodedVertex), and the shader rebuilds its colour
+// from a ColourTable holding one ColourStep per level and child. A vertex is 12
+// bytes instead of 24, and the colours can be swapped for a colour map without
+// generating again.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+#include <atomic>
+
+
+// Replace colourTable with the colours of iteration levels below the initial primitive
+void sierpinskiColourTable(const SierpinskiTriangle& triangle, int iteration, int totalIterations, ColourTable& colourTable);
+void levyColourTable(const LevyCCurve& line, int iteration, int totalIterations, ColourTable& colourTable);
+void treeColourTable(const Tree& branch, int iteration, int iterationCounter, ColourTable& colourTable);
+
+// Replace the contents of cpuGeom with codedVertices and colourTable, in the order the recursive
+// generators emit them. Throw std::runtime_error if the paths do not fit a colour code or
+// the colour table does not fit the shader
+void sierpinskiTriangleCreateCoded(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
+void levyCCurveCreateCoded(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
+void treeCreateCoded(const Tree& branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
@@ -0,0 +1,72 @@
+#include "ColourMap.h"
+
+#include <vivid/data/blue-yellow.h>
+#include <vivid/data/cool-warm.h>
+#include <vivid/data/inferno.h>
+#include <vivid/data/magma.h>
+#include <vivid/data/plasma.h>
+#include <vivid/data/rainbow.h>
+#include <vivid/data/turbo.h>
+#include <vivid/data/viridis.h>
+
+#include <stdexcept>
+
+
+bool colourMapColours(const std::string& name, std::vector<glm::vec3>& colours) {
+	const std::vector<vivid::srgb_t>* data = nullptr;
+	if (name == "viridis") {
+		data = &vivid::data::viridis;
+	}
+	else if (name == "turbo") {
+		data = &vivid::data::turbo;
+	}
+	else if (name == "magma") {
+		data = &vivid::data::magma;
+	}
+	else if (name == "inferno") {
+		data = &vivid::data::inferno;
+	}
+	else if (name == "plasma") {
+		data = &vivid::data::plasma;
+	}
+	else if (name == "cool-warm") {
+		data = &vivid::data::cool_warm;
+	}
+	else if (name == "blue-yellow") {
+		data = &vivid::data::blue_yellow;
+	}
+	else if (name == "rainbow") {
+		data = &vivid::data::rainbow;
+	}
+	else {
+		return false;
+	}
+
+	colours.clear();
+	colours.reserve(data->size());
+	for (const vivid::srgb_t& colour : *data) {
+		colours.push_back(glm::vec3(colour.x, colour.y, colour.z));
+	}
+	return true;
+}
+
+
+ColourMap::ColourMap(const std::string& name)
+	: textureID(), name(name)
+{
+	std::vector<glm::vec3> colours;
+	if (!colourMapColours(name, colours)) {
+		throw std::runtime_error("Unknown colour map: " + name);
+	}
+
+	bind();
+
+	// The framebuffer encodes what the shaders write as sRGB, so the map is decoded when sampled
+	glTexImage1D(GL_TEXTURE_1D, 0, GL_SRGB8, GLsizei(colours.size()), 0, GL_RGB, GL_FLOAT, colours.data());
+
+	glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	unbind();
+}
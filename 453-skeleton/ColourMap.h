@@ -0,0 +1,33 @@
+#pragma once
+
+#include "GLHandles.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+
+// Copies the colours of one of the colour maps bundled with vivid ("viridis", "turbo", "magma",
+// "inferno", "plasma", "cool-warm", "blue-yellow" or "rainbow") into colours.
+// Returns false for any other name
+bool colourMapColours(const std::string& name, std::vector<glm::vec3>& colours);
+
+
+// 1D texture holding a colour map, looked up with a parameter in [0, 1]
+class ColourMap {
+public:
+	// Throws std::runtime_error if name is not a bundled colour map
+	explicit ColourMap(const std::string& name);
+
+	// Public interface
+	std::string getName() const { return name; }
+
+	void bind() { glBindTexture(GL_TEXTURE_1D, textureID); }
+	void unbind() { glBindTexture(GL_TEXTURE_1D, 0); }
+
+private:
+	TextureHandle textureID;
+	std::string name;
+};
@@ -0,0 +1,148 @@
+#include "ComputeFractals.h"
+
+#ifdef USE_OPENGL_4_6
+
+#include "AssetPath.h"
+
+#include <stdexcept>
+
+
+namespace {
+
+	constexpr GLuint WORK_GROUP_SIZE = 64; // local_size_x of subdivide.comp and expand.comp
+
+	// Layout of glDrawArraysIndirect commands
+	struct DrawArraysIndirectCommand {
+		GLuint count;
+		GLuint instanceCount;
+		GLuint first;
+		GLuint baseInstance;
+	};
+
+	void dispatch(std::size_t invocations) {
+		glDispatchCompute(GLuint((invocations + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE), 1, 1);
+	}
+}
+
+
+ComputeGenerator::ComputeGenerator(VertexLayout layout)
+	: subdivideProgram(AssetPath::Instance()->Get("shaders/subdivide.comp"))
+	, expandProgram(AssetPath::Instance()->Get("shaders/expand.comp"))
+	, interleaved(layout == VertexLayout::Interleaved)
+{
+	if (layout == VertexLayout::Packed) {
+		throw std::runtime_error("Compute shaders cannot write packed vertices.");
+	}
+	DrawArraysIndirectCommand command = { 0, 1, 0, 0 };
+	commandBuffer.uploadData(sizeof(command), &command, GL_DYNAMIC_COPY);
+}
+
+
+void ComputeGenerator::reserveLevels(std::size_t primitiveCount) {
+	if (primitiveCount <= levelCapacity) {
+		return;
+	}
+	for (VertexBuffer& buffer : levelBuffers) {
+		buffer.uploadData(sizeof(SubdivisionPrimitive) * primitiveCount, nullptr, GL_DYNAMIC_COPY);
+	}
+	levelCapacity = primitiveCount;
+}
+
+
+// Writes the children of the parentCount primitives in levelBuffers[source] into the other buffer
+void ComputeGenerator::subdivide(int source, std::size_t parentCount, int branching) {
+	std::size_t childCount = parentCount * branching;
+	levelBuffers[source].bindRange(GL_SHADER_STORAGE_BUFFER, 0, 0, sizeof(SubdivisionPrimitive) * parentCount);
+	levelBuffers[1 - source].bindRange(GL_SHADER_STORAGE_BUFFER, 1, 0, sizeof(SubdivisionPrimitive) * childCount);
+	glUniform1ui(glGetUniformLocation(subdivideProgram, "childCount"), GLuint(childCount));
+
+	dispatch(childCount);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT); // The next level reads what this one wrote
+}
+
+
+// Writes the corners of the primitiveCount primitives in levelBuffers[source] into the geometry
+// bound to bindings 2 and 3
+void ComputeGenerator::expand(int source, std::size_t primitiveCount, int corners, std::size_t firstVertex) {
+	std::size_t vertexCount = primitiveCount * corners;
+	levelBuffers[source].bindRange(GL_SHADER_STORAGE_BUFFER, 0, 0, sizeof(SubdivisionPrimitive) * primitiveCount);
+	glUniform1ui(glGetUniformLocation(expandProgram, "vertexCount"), GLuint(vertexCount));
+	glUniform1ui(glGetUniformLocation(expandProgram, "firstVertex"), GLuint(firstVertex));
+
+	dispatch(vertexCount);
+}
+
+
+GLsizei ComputeGenerator::generate(const FractalRequest& request, GPU_Geometry& gpuGeom) {
+	SubdivisionPlan plan = planSubdivision(request);
+	const std::vector<std::size_t>& levelCounts = plan.levelCounts;
+
+	reserveLevels(levelCounts.back());
+	levelBuffers[0].updateData(0, sizeof(SubdivisionPrimitive), &plan.root);
+	gpuGeom.reserve(plan.vertexCount);
+
+	// Storage buffer offsets have to be aligned, so the whole geometry is bound and each
+	// dispatch is told where to start instead
+	gpuGeom.bindRange(GL_SHADER_STORAGE_BUFFER, 2, 0, plan.vertexCount);
+	if (interleaved) {
+		// Colours is only written for separate vertices, but every block the shader declares needs a buffer
+		gpuGeom.bindRange(GL_SHADER_STORAGE_BUFFER, 3, 0, plan.vertexCount);
+	}
+	DrawArraysIndirectCommand command = { 0, 1, 0, 0 };
+	commandBuffer.updateData(0, sizeof(command), &command);
+	commandBuffer.bindRange(GL_SHADER_STORAGE_BUFFER, 4, 0, sizeof(command));
+
+	subdivideProgram.use();
+	glUniform1i(glGetUniformLocation(subdivideProgram, "branching"), plan.branching);
+	glUniform1i(glGetUniformLocation(subdivideProgram, "scene"), request.sceneNumber);
+	glUniform1i(glGetUniformLocation(subdivideProgram, "totalIterations"), plan.totalIterations);
+	glUniformMatrix2fv(glGetUniformLocation(subdivideProgram, "branchRotations"), 2, GL_FALSE, &plan.branchRotations[0][0][0]);
+	expandProgram.use();
+	glUniform1i(glGetUniformLocation(expandProgram, "corners"), plan.corners);
+	glUniform1i(glGetUniformLocation(expandProgram, "interleaved"), interleaved);
+
+	// Tree levels are placed deepest first, as in the FeedbackGenerator
+	std::size_t deeperVertices = plan.vertexCount;
+	int source = 0;
+	for (int level = 0; level <= request.iteration; level++) {
+		if (plan.allLevels) {
+			deeperVertices -= levelCounts[level] * plan.corners;
+			expandProgram.use();
+			expand(source, levelCounts[level], plan.corners, deeperVertices);
+		}
+		if (level == request.iteration) {
+			break;
+		}
+
+		subdivideProgram.use();
+		glUniform1i(glGetUniformLocation(subdivideProgram, "iteration"), request.iteration - level);
+		glUniform1i(glGetUniformLocation(subdivideProgram, "iterationCounter"), level + 1);
+		subdivide(source, levelCounts[level], plan.branching);
+		source = 1 - source;
+	}
+
+	if (!plan.allLevels) {
+		expandProgram.use();
+		expand(source, levelCounts.back(), plan.corners, 0);
+	}
+
+	// The vertices are read as attributes and the count as a draw command
+	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+	return GLsizei(plan.vertexCount);
+}
+
+
+void ComputeGenerator::draw(GLenum primitive) {
+	commandBuffer.bind(GL_DRAW_INDIRECT_BUFFER);
+	glDrawArraysIndirect(primitive, nullptr);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+
+GLsizei ComputeGenerator::drawCount() const {
+	DrawArraysIndirectCommand command;
+	commandBuffer.downloadData(0, sizeof(command), &command);
+	return GLsizei(command.count);
+}
+
+#endif
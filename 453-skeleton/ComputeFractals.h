@@ -0,0 +1,59 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a generator that subdivides the fractals with compute
+// shaders. It needs OpenGL 4.3, so it is only built with USE_OPENGL_4_6 (the
+// USE_OPENGL_4_6 CMake option, which switches to the 4.6 loader).
+//
+// Like the FeedbackGenerator it keeps a level per buffer of a ping-pong pair,
+// but as shader storage buffers: subdivide.comp is one dispatch per level with
+// one invocation per child, and expand.comp writes the vertices straight into
+// the buffers of a GPU_Geometry. expand.comp also writes the vertex count into
+// an indirect draw command, so drawing never waits on the CPU.
+//------------------------------------------------------------------------------
+
+#ifdef USE_OPENGL_4_6
+
+#include "FeedbackFractals.h"
+#include "Fractals.h"
+#include "Geometry.h"
+#include "ShaderProgram.h"
+#include "VertexBuffer.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+
+
+class ComputeGenerator {
+public:
+	// Throws std::runtime_error if the shaders do not link or the layout is VertexLayout::Packed
+	explicit ComputeGenerator(VertexLayout layout);
+
+	// Fills gpuGeom (which must have the layout given to the constructor) with the requested
+	// scene, in the same order as the FeedbackGenerator. Returns the number of vertices, which
+	// draw() does not need
+	GLsizei generate(const FractalRequest& request, GPU_Geometry& gpuGeom);
+
+	// Draws the last generated scene from the bound GPU_Geometry with the count the GPU wrote
+	void draw(GLenum primitive);
+
+	// The count the GPU wrote for the last generated scene, to check it. Waits for the GPU
+	GLsizei drawCount() const;
+
+private:
+	ShaderProgram subdivideProgram;
+	ShaderProgram expandProgram;
+	bool interleaved;
+
+	std::array<VertexBuffer, 2> levelBuffers; // Ping-pong pair
+	std::size_t levelCapacity = 0; // Primitives each buffer has room for
+	VertexBuffer commandBuffer; // DrawArraysIndirectCommand
+
+	void reserveLevels(std::size_t primitiveCount);
+	void subdivide(int source, std::size_t parentCount, int branching);
+	void expand(int source, std::size_t primitiveCount, int corners, std::size_t firstVertex);
+};
+
+#endif
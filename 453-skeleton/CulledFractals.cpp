@@ -0,0 +1,395 @@
+#include "CulledFractals.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+
+namespace {
+
+	void clear(CPU_Geometry& cpuGeom) {
+		cpuGeom.verts.clear();
+		cpuGeom.cols.clear();
+	}
+
+
+	//------------------------------------------------------------------------------
+	// The scene primitives in double. The arithmetic (and its order) matches
+	// SierpinskiTriangle::subdivide, LevyCCurve::subdivide and Tree::grow, only the
+	// colours are still worked out in float, exactly as they are there.
+	//------------------------------------------------------------------------------
+
+	struct DeepTriangle {
+		glm::dvec2 A;
+		glm::dvec2 B;
+		glm::dvec2 C;
+		glm::vec3 colour;
+
+		explicit DeepTriangle(const SierpinskiTriangle& triangle)
+			: A(triangle.A), B(triangle.B), C(triangle.C), colour(triangle.colour) {}
+		DeepTriangle(const glm::dvec2& A, const glm::dvec2& B, const glm::dvec2& C, const glm::vec3& colour)
+			: A(A), B(B), C(C), colour(colour) {}
+
+		std::array<DeepTriangle, 3> subdivide(int iteration, int totalIterations) const {
+			glm::dvec2 D(0.5 * (A + C));
+			glm::dvec2 E(0.5 * (C + B));
+			glm::dvec2 F(0.5 * (B + A));
+
+			float increment = (static_cast<float>(iteration) / totalIterations) * 0.33f;
+			glm::vec3 leftColour = { colour.x, colour.y, colour.z + increment };
+			glm::vec3 rightColour = { colour.x, colour.y, colour.z - increment };
+			glm::vec3 topColour = { colour.x, colour.y - increment, colour.z };
+
+			return {
+				DeepTriangle(D, E, C, topColour),
+				DeepTriangle(F, B, E, leftColour),
+				DeepTriangle(A, F, D, rightColour)
+			};
+		}
+	};
+
+	struct DeepLine {
+		glm::dvec2 A;
+		glm::dvec2 B;
+		glm::vec3 colourA;
+		glm::vec3 colourB;
+
+		explicit DeepLine(const LevyCCurve& line)
+			: A(line.A), B(line.B), colourA(line.colourA), colourB(line.colourB) {}
+		DeepLine(const glm::dvec2& A, const glm::dvec2& B, const glm::vec3& colourA, const glm::vec3& colourB)
+			: A(A), B(B), colourA(colourA), colourB(colourB) {}
+
+		std::array<DeepLine, 2> subdivide(int iteration, int totalIterations) const {
+			double lengthX = B.x - A.x;
+			double lengthY = B.y - A.y;
+			glm::dvec2 C(A.x + (lengthX / 2) - (lengthY / 2), A.y + (lengthY / 2) + (lengthX / 2));
+
+			float colourMidpoint = (static_cast<float>(totalIterations) - iteration) / totalIterations;
+			glm::vec3 colourC = glm::mix(colourA, colourB, colourMidpoint);
+
+			return {
+				DeepLine(A, C, colourA, colourC),
+				DeepLine(C, B, colourC, colourB)
+			};
+		}
+	};
+
+	struct DeepBranch {
+		glm::dvec2 base;
+		glm::dvec2 top;
+		glm::vec3 colour;
+
+		explicit DeepBranch(const Tree& branch)
+			: base(branch.base), top(branch.top), colour(branch.colour) {}
+		DeepBranch(const glm::dvec2& base, const glm::dvec2& top, const glm::vec3& colour)
+			: base(base), top(top), colour(colour) {}
+
+		std::array<DeepBranch, 3> grow(int iterationCounter) const {
+			glm::vec3 childColour = (iterationCounter > 3) ? glm::vec3(0.1f, 0.4f, 0.f) : colour;
+
+			glm::dvec2 topTip(top + (top - base) / 2.0);
+			glm::dvec2 midpoint((base + top) * 0.5);
+			glm::dvec2 dirVec(top - base);
+
+			// Half the length of the branch, rotated 25.7 degrees either way
+			double cosine = std::cos(glm::radians(25.7));
+			double sine = std::sin(glm::radians(25.7));
+			glm::dvec2 leftBranchTip(glm::dvec2(cosine * dirVec.x - sine * dirVec.y, sine * dirVec.x + cosine * dirVec.y) * 0.5 + midpoint);
+			glm::dvec2 rightBranchTip(glm::dvec2(cosine * dirVec.x + sine * dirVec.y, -sine * dirVec.x + cosine * dirVec.y) * 0.5 + midpoint);
+
+			return {
+				DeepBranch(top, topTip, childColour),
+				DeepBranch(midpoint, leftBranchTip, childColour),
+				DeepBranch(midpoint, rightBranchTip, childColour)
+			};
+		}
+	};
+
+
+	//------------------------------------------------------------------------------
+	// Bounds
+	//------------------------------------------------------------------------------
+
+	// Axis aligned bounds of a subtree
+	struct Bounds {
+		glm::dvec2 min;
+		glm::dvec2 max;
+
+		void add(const glm::dvec2& point) {
+			min = glm::min(min, point);
+			max = glm::max(max, point);
+		}
+	};
+
+	Bounds boundsOf(const glm::dvec2& point) {
+		return { point, point };
+	}
+
+	bool isVisible(const Bounds& bounds, const ViewRegion& view) {
+		return bounds.max.x >= view.min.x && bounds.min.x <= view.max.x && bounds.max.y >= view.min.y && bounds.min.y <= view.max.y;
+	}
+
+	bool fitsInPixel(const Bounds& bounds, const ViewRegion& view) {
+		glm::dvec2 size = bounds.max - bounds.min;
+		return std::max(size.x, size.y) < view.pixelSize;
+	}
+
+	Bounds sierpinskiBounds(const DeepTriangle& triangle) {
+		Bounds bounds = boundsOf(triangle.A);
+		bounds.add(triangle.B);
+		bounds.add(triangle.C);
+		return bounds;
+	}
+
+	// Bounds of the box [uMin, uMax] x [vMin, vMax] in the frame of a line from origin, with the
+	// line along u and its left turn along v
+	Bounds frameBounds(const glm::dvec2& origin, const glm::dvec2& along, double uMin, double uMax, double vMin, double vMax) {
+		glm::dvec2 across(-along.y, along.x);
+		Bounds bounds = boundsOf(origin + uMin * along + vMin * across);
+		bounds.add(origin + uMax * along + vMin * across);
+		bounds.add(origin + uMin * along + vMax * across);
+		bounds.add(origin + uMax * along + vMax * across);
+		return bounds;
+	}
+
+	// The curve on the line from (0, 0) to (1, 0) spans [-0.5, 1.5] along the line and [-0.25, 1]
+	// across it (on the side subdivide puts the new points)
+	Bounds levyBounds(const DeepLine& line) {
+		return frameBounds(line.A, line.B - line.A, -0.5, 1.5, -0.25, 1.0);
+	}
+
+	// Each child is half as long as its parent. The top ones carry on straight, up to twice the
+	// length of the branch, and the side ones never get more than half of it to either side
+	Bounds treeBounds(const DeepBranch& branch) {
+		return frameBounds(branch.base, branch.top - branch.base, 0.0, 2.0, -0.5, 0.5);
+	}
+
+
+	//------------------------------------------------------------------------------
+	// Output
+	//
+	// A float keeps about 7 digits of a position, so a primitive reaching far
+	// outside a deep view would be drawn up to a pixel off or more, however
+	// precise its small neighbours are. So primitives are clipped to the view
+	// (grown by its size on every side, which covers panning until the next view
+	// arrives) before they are written relative to the origin of the view.
+	//------------------------------------------------------------------------------
+
+	Bounds clipBounds(const ViewRegion& view) {
+		glm::dvec2 margin = view.max - view.min;
+		return { view.min - margin, view.max + margin };
+	}
+
+	bool contains(const Bounds& bounds, const glm::dvec2& point) {
+		return point.x >= bounds.min.x && point.x <= bounds.max.x && point.y >= bounds.min.y && point.y <= bounds.max.y;
+	}
+
+	glm::vec3 relative(const glm::dvec2& point, const ViewRegion& view) {
+		return glm::vec3(glm::vec2(point - view.origin), 0.f);
+	}
+
+	// Clips the line from a to b to bounds (Liang-Barsky), giving the parameters of the part inside.
+	// Returns false if none of it is
+	bool clipLine(const glm::dvec2& a, const glm::dvec2& b, const Bounds& bounds, double& t0, double& t1) {
+		glm::dvec2 direction = b - a;
+		t0 = 0.0;
+		t1 = 1.0;
+		for (int axis = 0; axis < 2; axis++) {
+			const double p[2] = { -direction[axis], direction[axis] };
+			const double q[2] = { a[axis] - bounds.min[axis], bounds.max[axis] - a[axis] };
+			for (int side = 0; side < 2; side++) {
+				if (p[side] == 0.0) {
+					if (q[side] < 0.0) {
+						return false; // Parallel to this side and outside it
+					}
+					continue;
+				}
+				double t = q[side] / p[side];
+				if (p[side] < 0.0) {
+					t0 = std::max(t0, t);
+				}
+				else {
+					t1 = std::min(t1, t);
+				}
+			}
+		}
+		return t0 <= t1;
+	}
+
+	void addLine(const glm::dvec2& a, const glm::dvec2& b, const glm::vec3& colourA, const glm::vec3& colourB, const ViewRegion& view, CPU_Geometry& cpuGeom) {
+		double t0, t1;
+		if (!clipLine(a, b, clipBounds(view), t0, t1)) {
+			return;
+		}
+		cpuGeom.verts.push_back(relative(a + t0 * (b - a), view));
+		cpuGeom.verts.push_back(relative(a + t1 * (b - a), view));
+		cpuGeom.cols.push_back(glm::mix(colourA, colourB, float(t0)));
+		cpuGeom.cols.push_back(glm::mix(colourA, colourB, float(t1)));
+	}
+
+	// A triangle clipped by the four sides of a box has at most 3 + 4 corners
+	struct ClippedPolygon {
+		std::array<glm::dvec2, 7> corners;
+		std::size_t size = 0;
+	};
+
+	// Keeps the part of polygon on the side of axis where (coordinate - limit) * sign <= 0 (Sutherland-Hodgman)
+	ClippedPolygon clipPolygon(const ClippedPolygon& polygon, int axis, double limit, double sign) {
+		ClippedPolygon clipped;
+		for (std::size_t i = 0; i < polygon.size; i++) {
+			const glm::dvec2& current = polygon.corners[i];
+			const glm::dvec2& next = polygon.corners[(i + 1) % polygon.size];
+			double currentDistance = (current[axis] - limit) * sign;
+			double nextDistance = (next[axis] - limit) * sign;
+			if (currentDistance <= 0.0) {
+				clipped.corners[clipped.size++] = current;
+			}
+			if ((currentDistance < 0.0 && nextDistance > 0.0) || (currentDistance > 0.0 && nextDistance < 0.0)) {
+				clipped.corners[clipped.size++] = current + (next - current) * (currentDistance / (currentDistance - nextDistance));
+			}
+		}
+		return clipped;
+	}
+
+	void addTriangle(const DeepTriangle& triangle, const ViewRegion& view, CPU_Geometry& cpuGeom) {
+		Bounds bounds = clipBounds(view);
+		if (contains(bounds, triangle.A) && contains(bounds, triangle.B) && contains(bounds, triangle.C)) {
+			cpuGeom.verts.push_back(relative(triangle.A, view)); // Lower Left
+			cpuGeom.verts.push_back(relative(triangle.B, view)); // Lower Right
+			cpuGeom.verts.push_back(relative(triangle.C, view)); // Upper
+			cpuGeom.cols.insert(cpuGeom.cols.end(), 3, triangle.colour);
+			return;
+		}
+
+		ClippedPolygon polygon;
+		polygon.corners[0] = triangle.A;
+		polygon.corners[1] = triangle.B;
+		polygon.corners[2] = triangle.C;
+		polygon.size = 3;
+		polygon = clipPolygon(polygon, 0, bounds.min.x, -1.0);
+		polygon = clipPolygon(polygon, 0, bounds.max.x, 1.0);
+		polygon = clipPolygon(polygon, 1, bounds.min.y, -1.0);
+		polygon = clipPolygon(polygon, 1, bounds.max.y, 1.0);
+
+		// The clipped triangle is convex, so it is drawn as a fan
+		for (std::size_t i = 2; i < polygon.size; i++) {
+			cpuGeom.verts.push_back(relative(polygon.corners[0], view));
+			cpuGeom.verts.push_back(relative(polygon.corners[i - 1], view));
+			cpuGeom.verts.push_back(relative(polygon.corners[i], view));
+			cpuGeom.cols.insert(cpuGeom.cols.end(), 3, triangle.colour);
+		}
+	}
+
+
+	/*
+	* Creates vertices and colours for the part of the Sierpinski Triangle a view shows
+	*
+	* @param triangle	Initial triangle
+	* @param iteration	Most iterations to generate
+	* @param totalIterations	Number of iterations to be generated in total
+	* @param view	Region shown and the size of its pixels
+	* @param cpuGeom	Location of vertices and colours to render
+	* @param cancelled	Optional flag, generation stops early once it is set
+	*
+	*/
+	void sierpinskiTriangleCreateCulledInto(const DeepTriangle& triangle, int iteration, int totalIterations, const ViewRegion& view, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		Bounds bounds = sierpinskiBounds(triangle);
+		if (!isVisible(bounds, view)) {
+			return;
+		}
+
+		if (iteration > 0 && !fitsInPixel(bounds, view)) {
+			for (const DeepTriangle& child : triangle.subdivide(iteration, totalIterations)) {
+				sierpinskiTriangleCreateCulledInto(child, iteration - 1, totalIterations, view, cpuGeom, cancelled);
+			}
+		}
+		else {
+			addTriangle(triangle, view, cpuGeom); // Add vertices and colours to the output
+		}
+	}
+
+
+	/*
+	* Creates vertices and colours for the part of the Levy C Curve a view shows
+	*
+	* @param line	Initial line
+	* @param iteration	Most iterations to generate
+	* @param totalIterations	Number of iterations to be generated in total
+	* @param view	Region shown and the size of its pixels
+	* @param cpuGeom	Location of vertices and colours to render
+	* @param cancelled	Optional flag, generation stops early once it is set
+	*
+	*/
+	void levyCCurveCreateCulledInto(const DeepLine& line, int iteration, int totalIterations, const ViewRegion& view, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		Bounds bounds = levyBounds(line);
+		if (!isVisible(bounds, view)) {
+			return;
+		}
+
+		if (iteration > 0 && !fitsInPixel(bounds, view)) {
+			for (const DeepLine& child : line.subdivide(iteration, totalIterations)) {
+				levyCCurveCreateCulledInto(child, iteration - 1, totalIterations, view, cpuGeom, cancelled);
+			}
+		}
+		else {
+			addLine(line.A, line.B, line.colourA, line.colourB, view, cpuGeom); // Add vertices and colours to the output
+		}
+	}
+
+
+	/*
+	* Creates vertices and colours for the part of the Tree a view shows
+	*
+	* @param branch		Tree trunk
+	* @param iteration	Most iterations to generate
+	* @param iterationCounter	tracks number of iterations completed to detect when to start creating leaves
+	* @param view	Region shown and the size of its pixels
+	* @param cpuGeom	Location of vertices and colours to render
+	* @param cancelled	Optional flag, generation stops early once it is set
+	*
+	*/
+	void treeCreateCulledInto(const DeepBranch& branch, int iteration, int iterationCounter, const ViewRegion& view, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		Bounds bounds = treeBounds(branch);
+		if (!isVisible(bounds, view)) {
+			return;
+		}
+
+		// Children first, like treeCreate
+		if (iteration > 0 && !fitsInPixel(bounds, view)) {
+			for (const DeepBranch& child : branch.grow(iterationCounter + 1)) {
+				treeCreateCulledInto(child, iteration - 1, iterationCounter + 1, view, cpuGeom, cancelled);
+			}
+		}
+
+		addLine(branch.base, branch.top, branch.colour, branch.colour, view, cpuGeom); // Add vertices and colours to the output
+	}
+}
+
+
+void sierpinskiTriangleCreateCulled(const SierpinskiTriangle& triangle, int iteration, int totalIterations, const ViewRegion& view, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	clear(cpuGeom);
+	sierpinskiTriangleCreateCulledInto(DeepTriangle(triangle), iteration, totalIterations, view, cpuGeom, cancelled);
+}
+
+void levyCCurveCreateCulled(const LevyCCurve& line, int iteration, int totalIterations, const ViewRegion& view, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	clear(cpuGeom);
+	levyCCurveCreateCulledInto(DeepLine(line), iteration, totalIterations, view, cpuGeom, cancelled);
+}
+
+void treeCreateCulled(const Tree& branch, int iteration, int iterationCounter, const ViewRegion& view, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	clear(cpuGeom);
+	treeCreateCulledInto(DeepBranch(branch), iteration, iterationCounter, view, cpuGeom, cancelled);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains generators that only generate what a view shows.
+//
+// Every primitive of the three scenes bounds all of its descendants: the
+// Sierpinski Triangle stays inside its triangle, the Levy C Curve on a line AB
+// stays inside a box of 2 |AB| by 1.25 |AB| around it, and a tree grows up to
+// twice the length of its trunk and half of it to either side. A subtree whose
+// bounds miss the view is skipped, and one whose bounds fit inside a pixel is
+// drawn as its root instead of being subdivided further. So the work follows
+// what is on screen rather than the number of iterations, and zooming into a
+// corner of a figure costs about as much as showing all of it.
+//
+// The primitives are subdivided in double and written relative to the origin
+// of the view, clipped to a margin around it. So the vertices stay small
+// enough to be precise in float however deep the view is, and zooming is only
+// limited by how many iterations the generators may recurse.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+#include <atomic>
+
+
+// Replace the contents of cpuGeom with verts and cols of whatever part of the figure view
+// shows, relative to view.origin and in the order the recursive generators emit them. Stops at iteration levels below the
+// initial primitive at most, colours follow from totalIterations (or iterationCounter) as usual
+void sierpinskiTriangleCreateCulled(const SierpinskiTriangle& triangle, int iteration, int totalIterations, const ViewRegion& view, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
+void levyCCurveCreateCulled(const LevyCCurve& line, int iteration, int totalIterations, const ViewRegion& view, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
+void treeCreateCulled(const Tree& branch, int iteration, int iterationCounter, const ViewRegion& view, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
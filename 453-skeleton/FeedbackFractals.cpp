@@ -0,0 +1,148 @@
+#include "FeedbackFractals.h"
+
+#include "AssetPath.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+	GLenum feedbackModeFor(VertexLayout layout) {
+		if (layout == VertexLayout::Packed) {
+			throw std::runtime_error("Transform feedback cannot write packed vertices.");
+		}
+		return (layout == VertexLayout::Interleaved) ? GL_INTERLEAVED_ATTRIBS : GL_SEPARATE_ATTRIBS;
+	}
+
+	// The upper left of the rotation Tree::grow applies
+	glm::mat2 branchRotation(float degrees) {
+		return glm::mat2(glm::rotate(glm::mat4(1.0f), glm::radians(degrees), glm::vec3(0.f, 0.f, 1.f)));
+	}
+}
+
+
+SubdivisionPlan planSubdivision(const FractalRequest& request) {
+	const Scene& scene = fractalScene(request.sceneNumber);
+	SubdivisionPlan plan;
+	plan.root = scene.root();
+	plan.branching = scene.branching;
+	plan.corners = scene.corners;
+	plan.totalIterations = request.iteration * scene.stepsPerIteration; // As in generateFractal
+	plan.allLevels = scene.allLevels;
+
+	// Every level has branching times the primitives of the one before
+	plan.levelCounts.push_back(1);
+	for (int level = 0; level < request.iteration; level++) {
+		plan.levelCounts.push_back(plan.levelCounts.back() * plan.branching);
+	}
+	plan.vertexCount = fractalVertexCount(request);
+
+	plan.branchRotations[0] = branchRotation(25.7f);
+	plan.branchRotations[1] = branchRotation(-25.7f);
+	return plan;
+}
+
+
+FeedbackGenerator::FeedbackGenerator(VertexLayout layout)
+	: subdivideProgram(
+		AssetPath::Instance()->Get("shaders/subdivide.vert"),
+		{ "point0", "point1", "point2", "colour0", "colour1" },
+		GL_INTERLEAVED_ATTRIBS)
+	, expandProgram(
+		AssetPath::Instance()->Get("shaders/expand.vert"),
+		{ "position", "colour" },
+		feedbackModeFor(layout))
+{
+	for (int i = 0; i < 2; i++) {
+		levelArrays[i].bind();
+		levelBuffers[i].setInstanceAttribute(0, 2, GL_FLOAT, sizeof(SubdivisionPrimitive), offsetof(SubdivisionPrimitive, points[0]));
+		levelBuffers[i].setInstanceAttribute(1, 2, GL_FLOAT, sizeof(SubdivisionPrimitive), offsetof(SubdivisionPrimitive, points[1]));
+		levelBuffers[i].setInstanceAttribute(2, 2, GL_FLOAT, sizeof(SubdivisionPrimitive), offsetof(SubdivisionPrimitive, points[2]));
+		levelBuffers[i].setInstanceAttribute(3, 3, GL_FLOAT, sizeof(SubdivisionPrimitive), offsetof(SubdivisionPrimitive, colours[0]));
+		levelBuffers[i].setInstanceAttribute(4, 3, GL_FLOAT, sizeof(SubdivisionPrimitive), offsetof(SubdivisionPrimitive, colours[1]));
+	}
+}
+
+
+void FeedbackGenerator::reserveLevels(std::size_t primitiveCount) {
+	if (primitiveCount <= levelCapacity) {
+		return;
+	}
+	for (VertexBuffer& buffer : levelBuffers) {
+		buffer.uploadData(sizeof(SubdivisionPrimitive) * primitiveCount, nullptr, GL_DYNAMIC_COPY);
+	}
+	levelCapacity = primitiveCount;
+}
+
+
+// Writes the children of the parentCount primitives in levelBuffers[source] into the other buffer
+void FeedbackGenerator::subdivide(int source, std::size_t parentCount, int branching) {
+	levelArrays[source].bind();
+	levelBuffers[1 - source].bindRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0, sizeof(SubdivisionPrimitive) * parentCount * branching);
+
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArraysInstanced(GL_POINTS, 0, branching, GLsizei(parentCount));
+	glEndTransformFeedback();
+}
+
+
+// Writes the corners of the primitiveCount primitives in levelBuffers[source] into gpuGeom
+void FeedbackGenerator::expand(int source, std::size_t primitiveCount, int corners, GPU_Geometry& gpuGeom, std::size_t firstVertex) {
+	levelArrays[source].bind();
+	gpuGeom.bindRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, firstVertex, primitiveCount * corners);
+
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArraysInstanced(GL_POINTS, 0, corners, GLsizei(primitiveCount));
+	glEndTransformFeedback();
+}
+
+
+GLsizei FeedbackGenerator::generate(const FractalRequest& request, GPU_Geometry& gpuGeom) {
+	SubdivisionPlan plan = planSubdivision(request);
+	const std::vector<std::size_t>& levelCounts = plan.levelCounts;
+
+	reserveLevels(levelCounts.back());
+	levelBuffers[0].updateData(0, sizeof(SubdivisionPrimitive), &plan.root);
+	gpuGeom.reserve(plan.vertexCount);
+
+	subdivideProgram.use();
+	glUniform1i(glGetUniformLocation(subdivideProgram, "scene"), request.sceneNumber);
+	glUniform1i(glGetUniformLocation(subdivideProgram, "totalIterations"), plan.totalIterations);
+	glUniformMatrix2fv(glGetUniformLocation(subdivideProgram, "branchRotations"), 2, GL_FALSE, &plan.branchRotations[0][0][0]);
+
+	glEnable(GL_RASTERIZER_DISCARD); // Nothing is drawn, only captured
+
+	// Tree levels are placed deepest first, so that like in treeCreate the children
+	// come before their parents
+	std::size_t deeperVertices = plan.vertexCount;
+	int source = 0;
+	for (int level = 0; level <= request.iteration; level++) {
+		if (plan.allLevels) {
+			deeperVertices -= levelCounts[level] * plan.corners;
+			expandProgram.use();
+			expand(source, levelCounts[level], plan.corners, gpuGeom, deeperVertices);
+		}
+		if (level == request.iteration) {
+			break;
+		}
+
+		subdivideProgram.use();
+		glUniform1i(glGetUniformLocation(subdivideProgram, "iteration"), request.iteration - level);
+		glUniform1i(glGetUniformLocation(subdivideProgram, "iterationCounter"), level + 1);
+		subdivide(source, levelCounts[level], plan.branching);
+		source = 1 - source;
+	}
+
+	if (!plan.allLevels) {
+		expandProgram.use();
+		expand(source, levelCounts.back(), plan.corners, gpuGeom, 0);
+	}
+
+	glDisable(GL_RASTERIZER_DISCARD);
+	glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
+	return GLsizei(plan.vertexCount);
+}
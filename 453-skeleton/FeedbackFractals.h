@@ -0,0 +1,66 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a generator that subdivides the fractals on the GPU with
+// transform feedback, so the geometry never exists on the CPU.
+//
+// Every level is one instanced draw of subdivide.vert over the primitives of
+// the level before, one instance per parent and one vertex per child. The
+// children are captured into the other buffer of a ping-pong pair. expand.vert
+// then turns the primitives into vertices, captured straight into the buffers
+// of a GPU_Geometry. Only needs OpenGL 3.3, and runs on the thread that owns
+// the context (so not on the GenerationWorker).
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+#include "ShaderProgram.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+
+// How a GPU generator builds the requested scene
+struct SubdivisionPlan {
+	SubdivisionPrimitive root;
+	int branching = 3; // Children per primitive
+	int corners = 2; // Vertices per primitive
+	int totalIterations = 0; // As passed to subdivide
+	bool allLevels = false; // Keep the primitives of every level (deepest first), not just the last
+	std::vector<std::size_t> levelCounts; // Primitives per level, from the root
+	std::size_t vertexCount = 0; // Vertices of the finished figure
+	glm::mat2 branchRotations[2]; // Left and right branch rotations of Tree::grow
+};
+
+SubdivisionPlan planSubdivision(const FractalRequest& request);
+
+
+class FeedbackGenerator {
+public:
+	// Throws std::runtime_error if the shaders do not link or the layout is VertexLayout::Packed
+	explicit FeedbackGenerator(VertexLayout layout);
+
+	// Fills gpuGeom (which must have the layout given to the constructor) with the requested
+	// scene, in the order the recursive generators emit it, apart from the tree levels, which
+	// come deepest first. Returns the number of vertices written
+	GLsizei generate(const FractalRequest& request, GPU_Geometry& gpuGeom);
+
+private:
+	ShaderProgram subdivideProgram;
+	ShaderProgram expandProgram;
+
+	// Ping-pong pair, each with a VAO reading its primitives one per instance
+	std::array<VertexArray, 2> levelArrays;
+	std::array<VertexBuffer, 2> levelBuffers;
+	std::size_t levelCapacity = 0; // Primitives each buffer has room for
+
+	void reserveLevels(std::size_t primitiveCount);
+	void subdivide(int source, std::size_t parentCount, int branching);
+	void expand(int source, std::size_t primitiveCount, int corners, GPU_Geometry& gpuGeom, std::size_t firstVertex);
+};
@@ -0,0 +1,652 @@
+#include "Fractals.h"
+
+#include "CodedFractals.h"
+#include "CulledFractals.h"
+#include "HierarchicalFractals.h"
+#include "IncrementalFractals.h"
+#include "InstancedFractals.h"
+#include "IterativeFractals.h"
+#include "MeshFractals.h"
+#include "ParallelFractals.h"
+#include "PyramidFractals.h"
+#include "RandomAccessFractals.h"
+#include "SimdFractals.h"
+#include "StripFractals.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <stdexcept>
+
+
+namespace {
+
+	// Moves verts and cols into vertices or packedVertices, keeping the capacity of all of them
+	void pack(CPU_Geometry& cpuGeom, VertexLayout layout) {
+		std::size_t count = cpuGeom.verts.size();
+		if (layout == VertexLayout::Interleaved) {
+			cpuGeom.vertices.resize(count);
+			for (std::size_t i = 0; i < count; i++) {
+				cpuGeom.vertices[i] = { cpuGeom.verts[i], cpuGeom.cols[i] };
+			}
+		}
+		else if (layout == VertexLayout::Packed) {
+			cpuGeom.packedVertices.resize(count);
+			for (std::size_t i = 0; i < count; i++) {
+				cpuGeom.packedVertices[i] = packVertex(cpuGeom.verts[i], cpuGeom.cols[i]);
+			}
+		}
+		cpuGeom.verts.clear();
+		cpuGeom.cols.clear();
+	}
+
+	bool generateFractalSeparate(const FractalRequest& request, CPU_Geometry& cpuGeom, GeneratorType generator, const GenerationContext& context);
+}
+
+
+//------------------------------------------------------------------------------
+
+
+SierpinskiTriangle sierpinskiRoot() {
+	// vertices (initial triangle)
+	glm::vec3 ver1(- 0.75f, -float(sqrt(27)) / 8, 0.f );
+	glm::vec3 ver2(0.75f, -float(sqrt(27)) / 8, 0.f);
+	glm::vec3 ver3(0.f, float(sqrt(27)) / 8, 0.f);
+
+	// Initial triangle colour
+	glm::vec3 colourInit(1.f, 0.7f, .5f );
+
+	return SierpinskiTriangle(ver1, ver2, ver3, colourInit);
+}
+
+LevyCCurve levyRoot() {
+	// vertices (initial line of Levy C Curve)
+	glm::vec3 ver4(- 0.5f, -0.3f, 0.f);
+	glm::vec3 ver5( 0.5f, -0.3f, 0.f );
+
+	glm::vec3 colourLeft( 0.f, 1.f, 0.f );
+	glm::vec3 colourRight(0.f, 0.f, 1.f );
+	return LevyCCurve(ver4, ver5, colourLeft, colourRight);
+}
+
+Tree treeRoot() {
+	// Initial tree trunk
+	glm::vec3 trunkBase(0.f, -0.85f, 0.f);
+	glm::vec3 trunkTop(0.f, 0.f, 0.f);
+
+	glm::vec3 branchColour(.25f, .18f, .1f);
+	return Tree(trunkBase, trunkTop, branchColour);
+}
+
+
+//------------------------------------------------------------------------------
+
+
+std::array<SierpinskiTriangle, 3> SierpinskiTriangle::subdivide(int iteration, int totalIterations) const {
+	// New vertices from midpoins of triangle sides
+	glm::vec3 D(0.5f * (A + C));
+	glm::vec3 E(0.5f * (C + B));
+	glm::vec3 F(0.5f * (B + A));
+
+	float increment = (static_cast<float>(iteration) / totalIterations) * 0.33f; // Colour incremented based on iterations
+	glm::vec3	leftColour = { colour.x, colour.y, colour.z + increment}; // increase blue
+	glm::vec3	rightColour = { colour.x, colour.y, colour.z - increment }; // decrease blue 
+	glm::vec3	topColour = { colour.x, colour.y - increment, colour.z}; // decrease green
+
+	// Create new trianges using new vertices and vertices of previous triangles
+	return {
+		SierpinskiTriangle(D, E, C, topColour),
+		SierpinskiTriangle(F, B, E, leftColour),
+		SierpinskiTriangle(A, F, D, rightColour)
+	};
+}
+
+
+std::array<LevyCCurve, 2> LevyCCurve::subdivide(int iteration, int totalIterations) const {
+	// Get size of lines
+	float lengthX = B.x - A.x;
+	float lengthY = B.y - A.y;
+	// Add size of lines to point A
+	float newX = A.x + (lengthX / 2) - (lengthY / 2);
+	float newY = A.y + (lengthY / 2) + (lengthX / 2);
+	glm::vec3 C(newX, newY, 0.f); // Create new vertex C 
+
+	// Normalize iteration range so that each iteration has a value between 0 and 1
+	float colourMidpoint = (static_cast<float>(totalIterations) - iteration) / totalIterations; // Cast to avoid improper truncate
+
+	// Mix blue and green using colourMidpoint interpolant
+	glm::vec3 colourC = glm::mix(colourA, colourB, colourMidpoint);
+
+	// Create two new lines meeting at vertex C
+	return {
+		LevyCCurve(A, C, colourA, colourC),
+		LevyCCurve(C, B, colourC, colourB)
+	};
+}
+
+
+std::array<Tree, 3> Tree::grow(int iterationCounter) const {
+	glm::vec3 childColour;
+
+	// Change to colour to leaf colour if past iteration 3
+	if (iterationCounter > 3) {
+		glm::vec3 leaves(0.1f, 0.4f, 0.f);
+		childColour = leaves;
+	}
+	else (childColour = colour);
+
+	// Make new branch 1/2 the size of the previous
+	float lengthX = (top.x - base.x)/2;
+	float lengthY = (top.y - base.y)/2;
+
+	glm::vec3 topTip(top.x + lengthX, top.y + lengthY, 0.f); // Vertice of the tip of the top branch
+	glm::vec3 topConnect(top); // Vertice that connects top branch to tree
+
+	glm::vec3 midpoint((base + top) * .5f); // connecting point to trunk
+	glm::vec dirVec(top - base); // direction vector
+
+	// Make new branch 1/2 the size of the previous and rotated +25.7 degrees (left)
+	glm::mat4 rotate(glm::rotate(glm::mat4(1.0f), glm::radians(25.7f), glm::vec3(0.f, 0.f, 1.f))); // rotation matrix
+	glm::vec3 leftBranchTip(glm::vec3(rotate * glm::vec4(dirVec, 1.f)) * 0.5f); // left branch rotated and half the length of previous branch
+	leftBranchTip += midpoint; // translate to middle of previous branch
+
+	// Make new branch 1/2 the size of the previous and rotated -25.7 degrees (right)
+	rotate = (glm::rotate(glm::mat4(1.0f), glm::radians(-25.7f), glm::vec3(0.f, 0.f, 1.f))); // rotation matrix
+	glm::vec3 rightBranchTip(glm::vec3(rotate * glm::vec4(dirVec, 1.f)) * 0.5f); // right branch rotated and half the length of previous branch
+	rightBranchTip += midpoint; // translate to midpoint of previous branch
+
+	return {
+		Tree(topConnect, topTip, childColour), // Create top branch
+		Tree(midpoint, leftBranchTip, childColour),
+		Tree(midpoint, rightBranchTip, childColour)
+	};
+}
+
+
+//------------------------------------------------------------------------------
+
+
+std::size_t sierpinskiTriangleCount(int iteration) {
+	std::size_t count = 1;
+	for (int i = 0; i < iteration; i++) {
+		count *= 3;
+	}
+	return count;
+}
+
+
+std::size_t levySegmentCount(int iteration) {
+	return std::size_t(1) << iteration;
+}
+
+
+std::size_t treeBranchCount(int iteration) {
+	return (sierpinskiTriangleCount(iteration + 1) - 1) / 2;
+}
+
+
+std::size_t fractalVertexCount(const FractalRequest& request) {
+	const Scene& scene = fractalScene(request.sceneNumber);
+	return scene.corners * scene.primitiveCount(request.iteration);
+}
+
+
+namespace {
+
+	SubdivisionPrimitive primitiveOf(const SierpinskiTriangle& triangle) {
+		return { { triangle.A, triangle.B, triangle.C }, { triangle.colour, triangle.colour } };
+	}
+
+	SubdivisionPrimitive primitiveOf(const LevyCCurve& line) {
+		return { { line.A, line.B, line.B }, { line.colourA, line.colourB } };
+	}
+
+	SubdivisionPrimitive primitiveOf(const Tree& branch) {
+		return { { branch.base, branch.top, branch.top }, { branch.colour, branch.colour } };
+	}
+
+	// Points every iterative entry point of scene at generate, which takes any of their outputs
+	template <typename Generate>
+	void setIterative(Scene& scene, Generate generate) {
+		scene.iterative = generate;
+		scene.iterativeInterleaved = generate;
+		scene.iterativePacked = generate;
+		scene.iterativeInto = generate;
+		scene.iterativeChunks = generate;
+	}
+
+	// The entry points below hand each generator the root and iteration counts of its scene. The
+	// Sierpinski Triangle spreads its colours over as many steps as it has iterations, the Levy C
+	// Curve over twice as many, and the tree counts its iterations up from 0 instead
+
+	Scene sierpinskiScene() {
+		Scene scene = {};
+		scene.name = "Sierpinski Triangle";
+		scene.primitive = GL_TRIANGLES;
+		scene.maxIterations = 10;
+
+		scene.root = []() { return primitiveOf(sierpinskiRoot()); };
+		scene.branching = 3;
+		scene.corners = 3;
+		scene.stepsPerIteration = 1;
+		scene.allLevels = false;
+		scene.primitiveCount = sierpinskiTriangleCount;
+		scene.primitiveAt = [](const FractalRequest& request, std::size_t index) {
+			return primitiveOf(sierpinskiTriangleAt(sierpinskiRoot(), request.iteration, request.iteration, index));
+		};
+
+		scene.recursive = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			sierpinskiTriangleCreate(sierpinskiRoot(), request.iteration, request.iteration, cpuGeom, context.cancelled);
+		};
+		scene.parallel = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			sierpinskiTriangleCreateParallel(sierpinskiRoot(), request.iteration, request.iteration, cpuGeom, *context.pool, context.cancelled);
+		};
+		scene.simd = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			sierpinskiTriangleCreateSimd(sierpinskiRoot(), request.iteration, request.iteration, cpuGeom, context.cancelled, context.arena);
+		};
+		setIterative(scene, [](const FractalRequest& request, auto& output, const std::atomic<bool>* cancelled) {
+			sierpinskiTriangleCreateIterative(sierpinskiRoot(), request.iteration, request.iteration, output, cancelled);
+		});
+		scene.incremental = &FractalRefiner::generateSierpinski;
+
+		scene.culled = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			sierpinskiTriangleCreateCulled(sierpinskiRoot(), request.iteration, request.iteration, request.view, cpuGeom, context.cancelled);
+		};
+		scene.instanced = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			sierpinskiTriangleCreateInstanced(sierpinskiRoot(), request.iteration, request.iteration, cpuGeom, context.cancelled);
+		};
+		scene.mesh = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			sierpinskiTriangleCreateMesh(sierpinskiRoot(), request.iteration, request.iteration, cpuGeom, context.cancelled, context.arena);
+		};
+		scene.coded = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			sierpinskiTriangleCreateCoded(sierpinskiRoot(), request.iteration, request.iteration, cpuGeom, context.cancelled);
+		};
+
+		scene.vertexShader = "shaders/basic.vert";
+		scene.fragmentShader = "shaders/basic.frag";
+		scene.proceduralShader = "shaders/procedural.vert";
+		scene.pixelShader = "shaders/sierpinski.frag";
+		return scene;
+	}
+
+	Scene levyScene() {
+		Scene scene = {};
+		scene.name = "Levy C Curve";
+		scene.primitive = GL_LINES;
+		scene.maxIterations = 18;
+
+		scene.root = []() { return primitiveOf(levyRoot()); };
+		scene.branching = 2;
+		scene.corners = 2;
+		scene.stepsPerIteration = 2;
+		scene.allLevels = false;
+		scene.primitiveCount = levySegmentCount;
+		scene.primitiveAt = [](const FractalRequest& request, std::size_t index) {
+			return primitiveOf(levyCCurveAt(levyRoot(), request.iteration, request.iteration * 2, index));
+		};
+
+		scene.recursive = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			levyCCurveCreate(levyRoot(), request.iteration, request.iteration * 2, cpuGeom, context.cancelled);
+		};
+		scene.parallel = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			levyCCurveCreateParallel(levyRoot(), request.iteration, request.iteration * 2, cpuGeom, *context.pool, context.cancelled);
+		};
+		scene.simd = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			levyCCurveCreateSimd(levyRoot(), request.iteration, request.iteration * 2, cpuGeom, context.cancelled, context.arena);
+		};
+		setIterative(scene, [](const FractalRequest& request, auto& output, const std::atomic<bool>* cancelled) {
+			levyCCurveCreateIterative(levyRoot(), request.iteration, request.iteration * 2, output, cancelled);
+		});
+		scene.incremental = &FractalRefiner::generateLevy;
+
+		scene.culled = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			levyCCurveCreateCulled(levyRoot(), request.iteration, request.iteration * 2, request.view, cpuGeom, context.cancelled);
+		};
+		// Only a few steps per level, so there is nothing to cancel
+		scene.hierarchical = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext&) {
+			levyCCurveCreateHierarchy(levyRoot(), request.iteration, request.iteration * 2, cpuGeom);
+		};
+		scene.strips = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			levyCCurveCreateStrip(levyRoot(), request.iteration, request.iteration * 2, cpuGeom, context.cancelled);
+			if (context.format.layout != VertexLayout::Separate) {
+				pack(cpuGeom, context.format.layout);
+			}
+		};
+		scene.coded = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			levyCCurveCreateCoded(levyRoot(), request.iteration, request.iteration * 2, cpuGeom, context.cancelled);
+		};
+
+		scene.vertexShader = "shaders/basic.vert";
+		scene.fragmentShader = "shaders/basic.frag";
+		scene.proceduralShader = "shaders/procedural.vert";
+		scene.pixelShader = nullptr;
+		return scene;
+	}
+
+	Scene treeScene() {
+		Scene scene = {};
+		scene.name = "Tree";
+		scene.primitive = GL_LINES;
+		scene.maxIterations = 10;
+
+		scene.root = []() { return primitiveOf(treeRoot()); };
+		scene.branching = 3;
+		scene.corners = 2;
+		scene.stepsPerIteration = 1;
+		scene.allLevels = true;
+		scene.primitiveCount = treeBranchCount;
+		scene.primitiveAt = [](const FractalRequest& request, std::size_t index) {
+			return primitiveOf(treeBranchAt(treeRoot(), request.iteration, 0, index));
+		};
+
+		scene.recursive = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			treeCreate(treeRoot(), request.iteration, 0, cpuGeom, context.cancelled);
+		};
+		scene.parallel = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			treeCreateParallel(treeRoot(), request.iteration, 0, cpuGeom, *context.pool, context.cancelled);
+		};
+		scene.simd = nullptr; // A level of branches does not line up with SIMD lanes
+		setIterative(scene, [](const FractalRequest& request, auto& output, const std::atomic<bool>* cancelled) {
+			treeCreateIterative(treeRoot(), request.iteration, 0, output, cancelled);
+		});
+		scene.incremental = &FractalRefiner::generateTree;
+
+		scene.culled = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			treeCreateCulled(treeRoot(), request.iteration, 0, request.view, cpuGeom, context.cancelled);
+		};
+		// Only a few steps per level, so there is nothing to cancel
+		scene.hierarchical = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext&) {
+			treeCreateHierarchy(treeRoot(), request.iteration, 0, cpuGeom);
+		};
+		scene.strips = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			treeCreateStrips(treeRoot(), request.iteration, 0, cpuGeom, context.cancelled);
+		};
+		scene.coded = [](const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context) {
+			treeCreateCoded(treeRoot(), request.iteration, 0, cpuGeom, context.cancelled);
+		};
+
+		scene.vertexShader = "shaders/basic.vert";
+		scene.fragmentShader = "shaders/basic.frag";
+		scene.proceduralShader = nullptr;
+		scene.pixelShader = nullptr;
+		return scene;
+	}
+
+	// The output of format other than separate primitives that generateFractal writes the scene as,
+	// in the order it documents, and what kind of geometry that is. Null if there is none
+	SceneGenerator chooseOutput(const Scene& scene, const OutputFormat& format, GeometryKind& kind) {
+		struct Output {
+			bool wanted;
+			SceneGenerator generate;
+			GeometryKind kind;
+		};
+		const Output outputs[] = {
+			{ format.instanced, scene.instanced, GeometryKind::Instances },
+			{ format.mesh, scene.mesh, GeometryKind::Indexed },
+			{ format.hierarchical, scene.hierarchical, GeometryKind::Hierarchy },
+			{ format.strips, scene.strips, GeometryKind::Indexed },
+			{ format.coded, scene.coded, GeometryKind::Coded }
+		};
+		for (const Output& output : outputs) {
+			if (output.wanted && output.generate != nullptr) {
+				kind = output.kind;
+				return output.generate;
+			}
+		}
+		return nullptr;
+	}
+}
+
+
+const Scene& fractalScene(int sceneNumber) {
+	static const std::array<Scene, SCENE_COUNT> scenes = { sierpinskiScene(), levyScene(), treeScene() };
+	return scenes.at(sceneNumber);
+}
+
+
+void checkFractalDepth(int iteration) {
+	if (iteration > MAX_FRACTAL_DEPTH) {
+		throw std::runtime_error("Too many iterations for the generators.");
+	}
+}
+
+
+int fractalMaxIterations(int sceneNumber) {
+	return fractalScene(sceneNumber).maxIterations;
+}
+
+
+GLenum fractalPrimitive(int sceneNumber) {
+	return fractalScene(sceneNumber).primitive;
+}
+
+
+GLenum fractalPrimitive(int sceneNumber, const OutputFormat& format) {
+	const Scene& scene = fractalScene(sceneNumber);
+	GeometryKind kind;
+	if (!format.pyramid && !format.culled && scene.strips != nullptr && chooseOutput(scene, format, kind) == scene.strips) {
+		return GL_LINE_STRIP;
+	}
+	return scene.primitive;
+}
+
+
+bool parseGeneratorType(const std::string& name, GeneratorType& generator) {
+	if (name == "recursive") {
+		generator = GeneratorType::Recursive;
+	}
+	else if (name == "parallel") {
+		generator = GeneratorType::Parallel;
+	}
+	else if (name == "simd") {
+		generator = GeneratorType::Simd;
+	}
+	else if (name == "iterative") {
+		generator = GeneratorType::Iterative;
+	}
+	else if (name == "incremental") {
+		generator = GeneratorType::Incremental;
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+
+bool generateFractal(const FractalRequest& request, CPU_Geometry& cpuGeom, GeneratorType generator, const GenerationContext& context) {
+	cpuGeom.verts.clear();
+	cpuGeom.cols.clear();
+	cpuGeom.vertices.clear();
+	cpuGeom.packedVertices.clear();
+	cpuGeom.instances.clear();
+	cpuGeom.hierarchy.branching = 0;
+	cpuGeom.hierarchy.transforms.clear();
+	cpuGeom.codedVertices.clear();
+	cpuGeom.colourTable.steps.clear();
+	cpuGeom.indices.clear();
+	cpuGeom.shortIndices.clear();
+	cpuGeom.levels.clear();
+	cpuGeom.kind = GeometryKind::Vertices;
+
+	if (context.format.pyramid) {
+		return generateFractalPyramid(request, cpuGeom, generator, context);
+	}
+
+	const Scene& scene = fractalScene(request.sceneNumber);
+	if (context.format.culled) {
+		scene.culled(request, cpuGeom, context);
+		if (context.format.layout != VertexLayout::Separate) {
+			pack(cpuGeom, context.format.layout);
+		}
+		return !isCancelled(context.cancelled);
+	}
+
+	GeometryKind kind = GeometryKind::Vertices;
+	if (SceneGenerator output = chooseOutput(scene, context.format, kind)) {
+		cpuGeom.kind = kind;
+		output(request, cpuGeom, context);
+		return !isCancelled(context.cancelled);
+	}
+
+	// The iterative generators write interleaved and packed vertices directly
+	if (generator == GeneratorType::Iterative) {
+		if (context.format.layout == VertexLayout::Interleaved) {
+			scene.iterativeInterleaved(request, cpuGeom.vertices, context.cancelled);
+			return !isCancelled(context.cancelled);
+		}
+		if (context.format.layout == VertexLayout::Packed) {
+			scene.iterativePacked(request, cpuGeom.packedVertices, context.cancelled);
+			return !isCancelled(context.cancelled);
+		}
+	}
+
+	// Everything else is generated separately and packed afterwards
+	bool finished = generateFractalSeparate(request, cpuGeom, generator, context);
+	if (context.format.layout != VertexLayout::Separate) {
+		pack(cpuGeom, context.format.layout);
+	}
+	return finished;
+}
+
+
+bool generateFractal(const FractalRequest& request, const VertexDestination& destination, const std::atomic<bool>* cancelled) {
+	fractalScene(request.sceneNumber).iterativeInto(request, destination, cancelled);
+	return !isCancelled(cancelled);
+}
+
+
+bool generateFractal(const FractalRequest& request, const VertexChunks& chunks, const std::atomic<bool>* cancelled) {
+	fractalScene(request.sceneNumber).iterativeChunks(request, chunks, cancelled);
+	return !isCancelled(cancelled);
+}
+
+
+namespace {
+
+	bool generateFractalSeparate(const FractalRequest& request, CPU_Geometry& cpuGeom, GeneratorType generator, const GenerationContext& context) {
+		const std::atomic<bool>* cancelled = context.cancelled;
+		if (generator == GeneratorType::Incremental && context.refiner != nullptr) {
+			return context.refiner->generate(request, cpuGeom, cancelled);
+		}
+
+		const Scene& scene = fractalScene(request.sceneNumber);
+		if (generator == GeneratorType::Simd && scene.simd != nullptr) {
+			scene.simd(request, cpuGeom, context);
+		}
+		else if (generator == GeneratorType::Simd || generator == GeneratorType::Iterative) {
+			scene.iterative(request, cpuGeom, cancelled);
+		}
+		else if (generator == GeneratorType::Parallel && context.pool != nullptr) {
+			scene.parallel(request, cpuGeom, context);
+		}
+		else {
+			scene.recursive(request, cpuGeom, context);
+		}
+
+		return !isCancelled(cancelled);
+	}
+}
+
+
+/*
+* Creates vertices and colours for Sierpinski Triangle and adds them to the vertex and colour vectors
+* 
+* @param triangle	Triangle from previous iteration
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param cpuGeom	Collection of vectors for geometry
+* @param cancelled	Optional flag, generation stops early once it is set
+* 
+*/
+void sierpinskiTriangleCreate(SierpinskiTriangle triangle, int iteration, int totalIterations, CPU_Geometry & cpuGeom, const std::atomic<bool>* cancelled) {
+	if (isCancelled(cancelled)) {
+		return;
+	}
+
+	if (iteration > 0) {
+		// Create new trianges using new vertices and vertices of previous triangles
+		for (const SierpinskiTriangle& child : triangle.subdivide(iteration, totalIterations)) {
+			sierpinskiTriangleCreate(child, iteration - 1, totalIterations, cpuGeom, cancelled);
+		}
+	}
+	else {
+		// Add vertices to vertice vector
+		cpuGeom.verts.push_back(glm::vec3(triangle.A)); // Lower Left
+		cpuGeom.verts.push_back(glm::vec3(triangle.B)); // Lower Right
+		cpuGeom.verts.push_back(glm::vec3(triangle.C)); // Upper	
+
+		// Add colours to colour vector
+		cpuGeom.cols.push_back(glm::vec3(triangle.colour));
+		cpuGeom.cols.push_back(glm::vec3(triangle.colour));
+		cpuGeom.cols.push_back(glm::vec3(triangle.colour));
+	}
+}
+
+/*
+* Creates vertices and colours for Levy C Curve and adds them to the vertex and colour vectors
+*
+* @param line	Line from previous iteration
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param cpuGeom	Collection of vectors for geometry
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+void levyCCurveCreate(LevyCCurve line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	if (isCancelled(cancelled)) {
+		return;
+	}
+
+	if (iteration > 0) {
+		// Create two new lines meeting at a new vertex
+		for (const LevyCCurve& child : line.subdivide(iteration, totalIterations)) {
+			levyCCurveCreate(child, iteration - 1, totalIterations, cpuGeom, cancelled);
+		}
+	}
+
+	else {
+		// Add vertices to vertice vector
+		cpuGeom.verts.push_back(line.A); // Left point
+		cpuGeom.verts.push_back(line.B); // Right point
+
+		// Add colours to colour vector
+		cpuGeom.cols.push_back(glm::vec3(line.colourA));
+		cpuGeom.cols.push_back(glm::vec3(line.colourB));
+	}
+
+}
+
+/*
+* Creates vertices and colours for Tree scene and adds them to the vertex and colour vectors
+*
+* @param branch		branch (or leaf) from previous iteration
+* @param iteration	Number of iterations to generate
+* @param iterationCounter	tracks number of iterations completed to detect when to start creating leaves
+* @param cpuGeom	Collection of vectors for geometry
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+void treeCreate(Tree branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	if (isCancelled(cancelled)) {
+		return;
+	}
+
+	if (iteration > 0) {
+		iterationCounter++;
+
+		// Top, left and right branches, each half the size of the previous
+		for (const Tree& child : branch.grow(iterationCounter)) {
+			treeCreate(child, iteration - 1, iterationCounter, cpuGeom, cancelled);
+		}
+	}
+
+	// Add vertices to vertice vector
+	cpuGeom.verts.push_back(branch.base); // Left point
+	cpuGeom.verts.push_back(branch.top); // Right point
+
+	// Add colours to colour vector
+	cpuGeom.cols.push_back(glm::vec3(branch.colour));
+	cpuGeom.cols.push_back(glm::vec3(branch.colour));
+
+}
\ No newline at end of file
@@ -0,0 +1,293 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains the primitives and recursive generators for the three
+// fractal scenes (Sierpinski Triangle, Levy C Curve and Tree), and the shared
+// interface of every generator: what a request asks for (FractalRequest, with
+// its ViewRegion), how the result is written (OutputFormat, GenerationContext),
+// and the Scene table. Each entry holds a scene's root, counts and shaders and
+// the entry points of its generators in the other *Fractals files, which the
+// generateFractal entry points dispatch through
+//------------------------------------------------------------------------------
+
+#include "Geometry.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FractalRefiner;
+class TaskPool;
+struct VertexChunks;
+
+class SierpinskiTriangle {
+public:
+	// Triangle vertices
+	glm::vec3 A;
+	glm::vec3 B;
+	glm::vec3 C;
+
+	// Triangle colour
+	glm::vec3 colour;
+
+	// Triangle constructor
+	SierpinskiTriangle() = default;
+	SierpinskiTriangle(glm::vec3 x, glm::vec3 y, glm::vec3 z, glm::vec3 newColour) {
+
+		A = x;
+		B = y;
+		C = z;
+
+		colour = newColour;
+
+	}
+
+	// Splits the triangle into its three corner triangles, in generation order (top, left, right)
+	std::array<SierpinskiTriangle, 3> subdivide(int iteration, int totalIterations) const;
+};
+
+class LevyCCurve {
+public:
+	// Line verticles
+	glm::vec3 A;
+	glm::vec3 B;
+
+	// Colours
+	glm::vec3 colourA;
+	glm::vec3 colourB;
+
+	// Line constructor for C Curve
+	LevyCCurve() = default;
+	LevyCCurve(glm::vec3 x, glm::vec3 y, glm::vec3 colourLeft, glm::vec3 colourRight) {
+		A = x;
+		B = y;
+
+		colourA = colourLeft;
+		colourB = colourRight;
+	}
+
+	// Replaces the line with the two sides of a right angled triangle, in generation order (left, right)
+	std::array<LevyCCurve, 2> subdivide(int iteration, int totalIterations) const;
+};
+
+class Tree {
+public:
+
+	glm::vec3 base; // base of branch/leaf
+	glm::vec3 top; // tip of branch/leaf
+
+	glm::vec3 colour;
+
+	// Tree branch/leaf constructor
+	Tree() = default;
+	Tree(glm::vec3 base, glm::vec3 top, glm::vec3 colour) {
+		this->base = base;
+		this->top = top;
+
+		this->colour = colour;
+	}
+
+	// Grows the three child branches, in generation order (top, left, right).
+	// iterationCounter is the number of iterations completed including the children
+	std::array<Tree, 3> grow(int iterationCounter) const;
+};
+
+// Initial shapes of each scene
+SierpinskiTriangle sierpinskiRoot();
+LevyCCurve levyRoot();
+Tree treeRoot();
+
+// Part of the plane a view shows, for the culling generators (see CulledFractals.h). In double,
+// so it can be far smaller than the spacing of float positions
+struct ViewRegion {
+	glm::dvec2 min = glm::dvec2(-1.0);
+	glm::dvec2 max = glm::dvec2(1.0);
+	double pixelSize = 0.0; // Width of a pixel, 0 never stops early
+	glm::dvec2 origin = glm::dvec2(0.0); // The generated vertices are relative to this point
+
+	bool operator==(const ViewRegion& other) const { return min == other.min && max == other.max && pixelSize == other.pixelSize && origin == other.origin; }
+	bool operator!=(const ViewRegion& other) const { return !(*this == other); }
+};
+
+// Identifies one figure to generate
+struct FractalRequest {
+	int sceneNumber = 0;
+	int iteration = 0;
+	ViewRegion view; // Only the culling generators look at it
+
+	bool operator==(const FractalRequest& other) const { return sceneNumber == other.sceneNumber && iteration == other.iteration && view == other.view; }
+	bool operator!=(const FractalRequest& other) const { return !(*this == other); }
+};
+
+// Closed form number of primitives generated for a number of iterations
+std::size_t sierpinskiTriangleCount(int iteration); // 3^n triangles
+std::size_t levySegmentCount(int iteration); // 2^n lines
+std::size_t treeBranchCount(int iteration); // 1 + 3 + ... + 3^n branches
+std::size_t fractalVertexCount(const FractalRequest& request); // 3 per triangle, 2 per line
+
+// Any scene's primitive in one form, as the GPU generators store it: the corners of a triangle (or
+// the ends of a line in the first two) and the colours at the two ends (the same for triangles and branches)
+struct SubdivisionPrimitive {
+	glm::vec2 points[3];
+	glm::vec3 colours[2];
+};
+
+// Scene properties
+int fractalMaxIterations(int sceneNumber);
+GLenum fractalPrimitive(int sceneNumber);
+
+// Deepest recursion any generator supports
+constexpr int MAX_FRACTAL_DEPTH = 32;
+
+// Ways of generating a scene. All of them produce the same geometry, apart from the
+// differences noted in IncrementalFractals.h
+enum class GeneratorType {
+	Recursive, // The plain recursive generators below
+	Parallel, // Subtrees spread over a TaskPool (see ParallelFractals.h)
+	Simd, // One level at a time with SIMD kernels (see SimdFractals.h), falls back to Iterative for the tree
+	Iterative, // Explicit stack, no recursion or allocation (see IterativeFractals.h)
+	Incremental // Refines the previous iteration kept in a FractalRefiner (see IncrementalFractals.h)
+};
+
+// Parses "recursive", "parallel", "simd", "iterative" or "incremental", returns false for anything else
+bool parseGeneratorType(const std::string& name, GeneratorType& generator);
+
+// Scratch memory kept from one generation to the next, so that regenerating
+// a scene at a size that has been generated before does not allocate
+struct GenerationArena {
+	std::array<std::vector<float>, 4> levels; // Level buffers of the SIMD generators
+	std::unordered_map<std::uint64_t, GLuint> meshVertices; // Vertex lookup of the mesh generator
+};
+
+// What a generated scene is written as
+struct OutputFormat {
+	VertexLayout layout = VertexLayout::Separate; // Fill verts and cols, vertices or packedVertices
+	bool instanced = false; // Generate the Sierpinski Triangle as instances (see InstancedFractals.h)
+	bool hierarchical = false; // Generate the Levy C Curve and Tree as hierarchies (see HierarchicalFractals.h)
+	bool mesh = false; // Generate the Sierpinski Triangle as an indexed mesh (see MeshFractals.h)
+	bool strips = false; // Generate the Levy C Curve and Tree as connected paths (see StripFractals.h)
+	bool coded = false; // Generate colour codes instead of colours (see CodedFractals.h)
+	bool culled = false; // Only generate what the view of the request shows (see CulledFractals.h)
+	bool pyramid = false; // Generate every iteration up to the requested one (see PyramidFractals.h)
+};
+
+// Primitive the scene is drawn with in format
+GLenum fractalPrimitive(int sceneNumber, const OutputFormat& format);
+
+// Everything a generator may use besides its output
+struct GenerationContext {
+	const std::atomic<bool>* cancelled = nullptr; // Generation stops early once this is set
+	TaskPool* pool = nullptr; // Threads for the parallel generator
+	GenerationArena* arena = nullptr; // Reused scratch memory
+	FractalRefiner* refiner = nullptr; // Resident levels for the incremental generator
+	OutputFormat format;
+};
+
+// Whether a generator should stop early, cancelled may be null
+inline bool isCancelled(const std::atomic<bool>* cancelled) {
+	return cancelled != nullptr && cancelled->load(std::memory_order_relaxed);
+}
+
+// Throws std::runtime_error if iteration is above MAX_FRACTAL_DEPTH, for the generators that
+// count their primitives with fixed width integers
+void checkFractalDepth(int iteration);
+
+// Writes the requested iteration of one scene into cpuGeom in one of the ways generateFractal
+// offers, starting from the scene's root
+using SceneGenerator = void (*)(const FractalRequest& request, CPU_Geometry& cpuGeom, const GenerationContext& context);
+
+// Same, for the iterative generators that write straight into output
+template <typename Output>
+using IterativeSceneGenerator = void (*)(const FractalRequest& request, Output& output, const std::atomic<bool>* cancelled);
+
+// Everything about one scene: how it is subdivided and drawn, and the entry points of its
+// generators. The scenes are numbered by their place in the table, 0 up to SCENE_COUNT - 1
+struct Scene {
+	const char* name;
+	GLenum primitive; // Of its separate primitives
+	int maxIterations; // For the generators, which keep every primitive
+
+	SubdivisionPrimitive (*root)(); // The primitive every generator starts from
+	int branching; // Children per primitive
+	int corners; // Vertices per primitive
+	int stepsPerIteration; // totalIterations of the generators per iteration (the tree counts up from 0 instead)
+	bool allLevels; // Every level is part of the figure, not just the deepest
+	std::size_t (*primitiveCount)(int iteration); // Closed form
+	SubdivisionPrimitive (*primitiveAt)(const FractalRequest& request, std::size_t index); // See RandomAccessFractals.h
+
+	// Separate primitives, with each GeneratorType. simd is null where the iterative generator stands in
+	SceneGenerator recursive;
+	SceneGenerator parallel; // Needs context.pool
+	SceneGenerator simd;
+	IterativeSceneGenerator<CPU_Geometry> iterative;
+	IterativeSceneGenerator<std::vector<Vertex>> iterativeInterleaved;
+	IterativeSceneGenerator<std::vector<PackedVertex>> iterativePacked;
+	IterativeSceneGenerator<const VertexDestination> iterativeInto;
+	IterativeSceneGenerator<const VertexChunks> iterativeChunks;
+	bool (FractalRefiner::*incremental)(int iteration, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled); // See IncrementalFractals.h
+
+	// The other outputs of OutputFormat, null where the scene has no such output
+	SceneGenerator culled;
+	SceneGenerator instanced;
+	SceneGenerator mesh;
+	SceneGenerator hierarchical;
+	SceneGenerator strips;
+	SceneGenerator coded;
+
+	// Shaders under assets/shaders. Plain vertices of the scene are drawn with vertexShader and fragmentShader
+	const char* vertexShader;
+	const char* fragmentShader;
+	const char* proceduralShader; // Vertex shader drawing it from vertex indices alone (see ProceduralFractals.h), or null
+	const char* pixelShader; // Fragment shader drawing it per pixel over a full screen triangle, or null
+};
+
+constexpr int SCENE_COUNT = 3;
+
+// Entry of the table. Throws std::out_of_range for a number without a scene
+const Scene& fractalScene(int sceneNumber);
+
+// Generates the requested scene into cpuGeom (which is cleared first), as verts and cols, or as
+// vertices or packedVertices for the other layouts. Only the iterative generator writes those
+// directly, the others are packed into them after generating.
+// The parallel generator needs a pool and the incremental generator needs a refiner,
+// without them the recursive generator is used instead.
+// With format.instanced (or else format.mesh) the Sierpinski Triangle is always written as a
+// shape and instances (or an indexed mesh), and with format.hierarchical (or else format.strips)
+// the other scenes are always written as hierarchies (or paths), whatever the generator. The
+// layout applies to the Levy C Curve paths, the tree paths are always indexed vertices.
+// Whatever none of those apply to is written as codedVertices with format.coded.
+// format.culled comes before all of those, culled scenes are always separate primitives. They
+// should not be packed, their positions relative to the view go past the range packing keeps.
+// format.pyramid comes before everything, and writes every level as plain vertices in the layout.
+// Returns false if generation was cancelled part way through
+bool generateFractal(const FractalRequest& request, CPU_Geometry& cpuGeom, GeneratorType generator = GeneratorType::Recursive, const GenerationContext& context = {});
+
+// Generates the requested scene with the iterative generator straight into destination, which
+// needs room for fractalVertexCount(request) vertices (see GPU_MappedGeometry).
+// Returns false if generation was cancelled part way through
+bool generateFractal(const FractalRequest& request, const VertexDestination& destination, const std::atomic<bool>* cancelled = nullptr);
+
+// Where a chunked generation hands its vertices. emit gets each chunk as soon as it is full, and
+// may take its contents (by swapping in another vector, for example)
+struct VertexChunks {
+	std::size_t chunkSize = 0; // Vertices per chunk, the last one may be shorter
+	std::function<void(std::vector<Vertex>& chunk)> emit;
+};
+
+// Generates the requested scene with the iterative generator as interleaved vertices, handing
+// them to chunks while generating (see StreamingWorker.h).
+// Returns false if generation was cancelled part way through
+bool generateFractal(const FractalRequest& request, const VertexChunks& chunks, const std::atomic<bool>* cancelled = nullptr);
+
+// Function prototypes
+void sierpinskiTriangleCreate(SierpinskiTriangle triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
+void levyCCurveCreate(LevyCCurve curve, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
+void treeCreate(Tree branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
@@ -146,6 +146,44 @@ GLuint VertexBufferHandle::value() const {
 }
 
 
+//------------------------------------------------------------------------------
+
+
+IndexBufferHandle::IndexBufferHandle()
+	: iboID(0) // Due to OpenGL syntax, we can't initial directly here, like we want.
+{
+	glGenBuffers(1, &iboID);
+}
+
+
+IndexBufferHandle::IndexBufferHandle(IndexBufferHandle&& other) noexcept
+	: iboID(std::move(other.iboID))
+{
+	other.iboID = 0;
+}
+
+
+IndexBufferHandle& IndexBufferHandle::operator=(IndexBufferHandle&& other) noexcept {
+	std::swap(iboID, other.iboID);
+	return *this;
+}
+
+
+IndexBufferHandle::~IndexBufferHandle() {
+	glDeleteBuffers(1, &iboID);
+}
+
+
+IndexBufferHandle::operator GLuint() const {
+	return iboID;
+}
+
+
+GLuint IndexBufferHandle::value() const {
+	return iboID;
+}
+
+
 //------------------------------------------------------------------------------
 
 TextureHandle::TextureHandle()
@@ -180,3 +218,38 @@ TextureHandle::operator GLuint() const {
 GLuint TextureHandle::value() const {
 	return textureID;
 }
+
+
+//------------------------------------------------------------------------------
+
+
+FenceHandle::FenceHandle()
+	: fenceID(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+{}
+
+
+FenceHandle::FenceHandle(FenceHandle&& other) noexcept
+	: fenceID(std::move(other.fenceID))
+{
+	other.fenceID = nullptr;
+}
+
+FenceHandle& FenceHandle::operator=(FenceHandle&& other) noexcept {
+	std::swap(fenceID, other.fenceID);
+	return *this;
+}
+
+
+FenceHandle::~FenceHandle() {
+	glDeleteSync(fenceID); // Silently ignores nullptr
+}
+
+
+FenceHandle::operator GLsync() const {
+	return fenceID;
+}
+
+
+GLsync FenceHandle::value() const {
+	return fenceID;
+}
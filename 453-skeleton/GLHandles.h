@@ -154,6 +154,34 @@ private:
 
 };
 
+// An RAII class for managing an IndexBuffer GLuint for OpenGL.
+class IndexBufferHandle {
+
+public:
+	IndexBufferHandle();
+
+	// Disallow copying
+	IndexBufferHandle(const IndexBufferHandle&) = delete;
+	IndexBufferHandle operator=(const IndexBufferHandle&) = delete;
+
+	// Allow moving
+	IndexBufferHandle(IndexBufferHandle&& other) noexcept;
+	IndexBufferHandle& operator=(IndexBufferHandle&& other) noexcept;
+
+	// Clean up after ourselves.
+	~IndexBufferHandle();
+
+
+	// Allow casting from this type into a GLuint
+	// This allows usage in situations where a function expects a GLuint
+	operator GLuint() const;
+	GLuint value() const;
+
+private:
+	GLuint iboID;
+
+};
+
 // An RAII class for managing a VertexBuffer GLuint for OpenGL.
 class TextureHandle {
 
@@ -181,3 +209,32 @@ private:
 	GLuint textureID;
 
 };
+
+// An RAII class for managing a fence GLsync for OpenGL. Unlike the others it is a pointer,
+// created signalled once the GPU reaches the commands issued before it
+class FenceHandle {
+
+public:
+	FenceHandle();
+
+
+	// Disallow copying
+	FenceHandle(const FenceHandle&) = delete;
+	FenceHandle operator=(const FenceHandle&) = delete;
+
+	// Allow moving
+	FenceHandle(FenceHandle&& other) noexcept;
+	FenceHandle& operator=(FenceHandle&& other) noexcept;
+
+	// Clean up after ourselves.
+	~FenceHandle();
+
+	// Allow casting from this type into a GLsync
+	// This allows usage in situations where a function expects a GLsync
+	operator GLsync() const;
+	GLsync value() const;
+
+private:
+	GLsync fenceID;
+
+};
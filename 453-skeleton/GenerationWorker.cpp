@@ -0,0 +1,233 @@
+#include "GenerationWorker.h"
+
+#include <utility>
+
+
+void GeometryTripleBuffer::publish() {
+	// Hand the written slot over as the new middle and take the old middle to write into next
+	int previous = middleIndex.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+	writeIndex = previous & ~FRESH_BIT;
+}
+
+
+bool GeometryTripleBuffer::acquire() {
+	if ((middleIndex.load(std::memory_order_acquire) & FRESH_BIT) == 0) {
+		return false;
+	}
+	int previous = middleIndex.exchange(readIndex, std::memory_order_acq_rel);
+	readIndex = previous & ~FRESH_BIT;
+	return true;
+}
+
+
+//------------------------------------------------------------------------------
+
+
+GenerationWorker::GenerationWorker(std::function<void()> onPublish, GeneratorType generator, const OutputFormat& format)
+	: onPublish(std::move(onPublish))
+	, generator(generator)
+	, format(format)
+	, thread(&GenerationWorker::run, this)
+{}
+
+
+GenerationWorker::~GenerationWorker() {
+	stop();
+}
+
+
+void GenerationWorker::request(const FractalRequest& newRequest) {
+	queue(newRequest, std::nullopt);
+}
+
+
+void GenerationWorker::requestInto(const FractalRequest& newRequest, const VertexDestination& destination) {
+	queue(newRequest, destination);
+}
+
+
+void GenerationWorker::queue(const FractalRequest& newRequest, const std::optional<VertexDestination>& destination) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// The prefetches were guesses for the state before this one
+		prefetches.clear();
+		handBackPending();
+
+		// Already being generated, drop anything queued behind it. A prefetch of it is published once done.
+		// Unless it has been cancelled already, it may have stopped early, so it is queued again
+		if (isRunning && running == newRequest && !cancelled && !destination && !runningInto) {
+			hasPending = false;
+			runningPrefetch = false;
+			return;
+		}
+
+		pending = newRequest;
+		pendingDestination = destination;
+		hasPending = true;
+
+		// Whatever is running now is stale
+		if (isRunning) {
+			cancelled = true;
+		}
+	}
+	wake.notify_one();
+}
+
+
+void GenerationWorker::prefetch(const std::vector<FractalRequest>& requests) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		prefetches.assign(requests.begin(), requests.end());
+	}
+	wake.notify_one();
+}
+
+
+void GenerationWorker::cancel() {
+	bool handedBack = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		prefetches.clear();
+		handedBack = handBackPending();
+		hasPending = false;
+		if (isRunning) {
+			cancelled = true;
+		}
+	}
+	if (handedBack) {
+		onPublish();
+	}
+}
+
+
+bool GenerationWorker::handBackPending() {
+	if (!hasPending || !pendingDestination) {
+		return false;
+	}
+	written = pending;
+	writtenFinished = false;
+	hasWritten = true;
+	pendingDestination.reset();
+	return true;
+}
+
+
+bool GenerationWorker::acquireWritten(FractalRequest& request, bool& finished) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!hasWritten) {
+		return false;
+	}
+	request = written;
+	finished = writtenFinished;
+	hasWritten = false;
+	return true;
+}
+
+
+bool GenerationWorker::acquirePrefetched(GeneratedGeometry& generated) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (prefetched.empty()) {
+		return false;
+	}
+	generated = std::move(prefetched.back());
+	prefetched.pop_back();
+	return true;
+}
+
+
+void GenerationWorker::stop() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (stopping) {
+			return;
+		}
+		stopping = true;
+		cancelled = true;
+	}
+	wake.notify_one();
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+
+void GenerationWorker::run() {
+	while (true) {
+		FractalRequest job;
+		std::optional<VertexDestination> destination;
+		bool prefetching = false;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return hasPending || !prefetches.empty() || stopping; });
+			if (stopping) {
+				return;
+			}
+			prefetching = !hasPending;
+			if (prefetching) {
+				job = prefetches.front();
+				prefetches.pop_front();
+			}
+			else {
+				job = pending;
+				destination = pendingDestination;
+				pendingDestination.reset();
+				hasPending = false;
+			}
+			running = job;
+			isRunning = true;
+			runningInto = destination.has_value();
+			runningPrefetch = prefetching;
+			cancelled = false;
+		}
+
+		// Written into mapped buffers, which go back to the render loop whether finished or not
+		if (destination) {
+			bool finished = generateFractal(job, *destination, &cancelled);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isRunning = false;
+				written = job;
+				writtenFinished = finished;
+				hasWritten = true;
+			}
+			onPublish();
+			continue;
+		}
+
+		// Prefetches are written to their own slot, the triple buffer only ever holds requested results
+		GeneratedGeometry& slot = prefetching ? prefetchSlot : results.writeSlot();
+		bool finished = generateFractal(job, slot.cpuGeom, generator, { &cancelled, &pool, &arena, &refiner, format });
+		slot.request = job;
+		slot.primitive = fractalPrimitive(job.sceneNumber, format);
+
+		bool publish = false;
+		bool kept = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			isRunning = false;
+			if (runningPrefetch) {
+				// Still good for later, even if something else has been requested since
+				if (finished) {
+					prefetched.push_back(std::move(prefetchSlot));
+					kept = true;
+				}
+			}
+			else {
+				// A newer request arrived for something else, so this result is already stale
+				publish = finished && !(hasPending && pending != job);
+			}
+		}
+
+		if (publish) {
+			// A prefetch that was requested while it ran moves over to the triple buffer
+			if (prefetching) {
+				std::swap(results.writeSlot(), prefetchSlot);
+			}
+			results.publish();
+		}
+		if (publish || kept) {
+			onPublish();
+		}
+	}
+}
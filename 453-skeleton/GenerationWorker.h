@@ -0,0 +1,153 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a background thread that generates fractal geometry off
+// the GLFW/OpenGL thread and hands finished results to the render loop
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+#include "IncrementalFractals.h"
+#include "TaskPool.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+
+// One finished piece of geometry together with the request it was built for
+struct GeneratedGeometry {
+	FractalRequest request;
+	GLenum primitive = GL_TRIANGLES;
+	CPU_Geometry cpuGeom;
+};
+
+
+// Lock free triple buffer.
+//
+// The producer always owns one slot to write into and the consumer always owns one
+// slot to read from. The third slot holds the most recently published result, and
+// both sides swap their slot with it, so neither side ever waits on the other.
+class GeometryTripleBuffer {
+
+public:
+	GeometryTripleBuffer() = default;
+
+	// Disallow copying and moving, both threads hold references into the slots
+	GeometryTripleBuffer(const GeometryTripleBuffer&) = delete;
+	GeometryTripleBuffer operator=(const GeometryTripleBuffer&) = delete;
+
+	// Producer side
+	GeneratedGeometry& writeSlot() { return slots[writeIndex]; }
+	void publish();
+
+	// Consumer side. Returns true if a newer result was swapped into readSlot()
+	bool acquire();
+	const GeneratedGeometry& readSlot() const { return slots[readIndex]; }
+
+private:
+	static constexpr int FRESH_BIT = 4; // Set on the middle index when it has not been read yet
+
+	std::array<GeneratedGeometry, 3> slots;
+	int writeIndex = 0;
+	std::atomic<int> middleIndex{ 1 };
+	int readIndex = 2;
+};
+
+
+// Generates fractals on a worker thread.
+//
+// Only the most recent request is ever completed. Requests made while a job is running
+// replace any pending one and cancel the running job, so bursts of input (scrolling
+// through iterations, for example) coalesce into a single generation.
+//
+// While there is no request the worker works through a list of prefetches, states that are
+// likely to be asked for next. Their results are kept apart from the requested ones, for
+// acquirePrefetched(). A request cancels a running prefetch, unless it asks for the same
+// state, which is then finished and published like a requested one.
+//
+// A request can also be written straight into mapped vertex buffers (see GPU_MappedGeometry),
+// which only the render loop can map and unmap. The worker hands such a destination back
+// through acquireWritten() once it stops writing into it, whether it finished or not.
+class GenerationWorker {
+
+public:
+	// onPublish is called from the worker thread whenever a new result is available.
+	// It should only do thread safe things, such as glfwPostEmptyEvent()
+	GenerationWorker(std::function<void()> onPublish, GeneratorType generator, const OutputFormat& format = {});
+	~GenerationWorker();
+
+	// Disallow copying and moving, the thread holds a pointer to this
+	GenerationWorker(const GenerationWorker&) = delete;
+	GenerationWorker operator=(const GenerationWorker&) = delete;
+
+	// Public interface
+	void request(const FractalRequest& newRequest);
+	bool acquire() { return results.acquire(); }
+	const GeneratedGeometry& latest() const { return results.readSlot(); }
+
+	// Replaces the prefetches that have not been started. A request drops them as well
+	void prefetch(const std::vector<FractalRequest>& requests);
+
+	// Moves a finished prefetch into generated. Returns false if there is none
+	bool acquirePrefetched(GeneratedGeometry& generated);
+
+	// Generates newRequest with the iterative generator straight into destination, which needs room
+	// for fractalVertexCount(newRequest) vertices. Like request() otherwise, but only one destination
+	// may be out at a time, so wait for acquireWritten() before handing over the next one
+	void requestInto(const FractalRequest& newRequest, const VertexDestination& destination);
+
+	// Cancels whatever is running or pending. A pending destination is handed back unwritten
+	void cancel();
+
+	// Returns true once the destination of requestInto() is no longer written, with its request and
+	// whether it was written completely. Only then may it be unmapped
+	bool acquireWritten(FractalRequest& request, bool& finished);
+
+	// Stops and joins the thread. Called by the destructor if not done earlier
+	void stop();
+
+private:
+	std::function<void()> onPublish;
+	GeneratorType generator;
+	OutputFormat format;
+	GeometryTripleBuffer results; // The slots keep their capacity, so they double as output arenas
+	TaskPool pool; // Each job is split across these threads
+	GenerationArena arena; // Scratch memory reused by every job
+	FractalRefiner refiner; // Levels kept between jobs for the incremental generator
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	FractalRequest pending;
+	bool hasPending = false;
+	std::optional<VertexDestination> pendingDestination; // Where pending is written, if not to results
+
+	FractalRequest written; // Request of the destination handed back
+	bool writtenFinished = false;
+	bool hasWritten = false;
+	bool stopping = false;
+
+	std::deque<FractalRequest> prefetches; // Not started yet
+	std::vector<GeneratedGeometry> prefetched; // Finished, waiting for acquirePrefetched
+	GeneratedGeometry prefetchSlot; // Output of the running prefetch
+
+	FractalRequest running;
+	bool isRunning = false;
+	bool runningPrefetch = false;
+	bool runningInto = false; // Into a destination of requestInto()
+	std::atomic<bool> cancelled{ false };
+
+	std::thread thread;
+
+	void run();
+	void queue(const FractalRequest& newRequest, const std::optional<VertexDestination>& destination);
+	bool handBackPending(); // Under the lock. Returns true if the pending request had a destination
+};
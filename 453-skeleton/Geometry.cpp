@@ -1,18 +1,423 @@
 #include "Geometry.h"
 
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <stdexcept>
 #include <utility>
 
 
-GPU_Geometry::GPU_Geometry()
+namespace {
+
+	// Points attributes 0 (position) and 1 (colour) of the bound VAO at the VBO(s) of layout.
+	// colorsBuffer is only used, and has to be there, for VertexLayout::Separate
+	void setVertexAttributes(VertexLayout layout, VertexBuffer& vertBuffer, std::optional<VertexBuffer>& colorsBuffer) {
+		if (layout == VertexLayout::Interleaved) {
+			vertBuffer.setAttribute(0, 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, position));
+			vertBuffer.setAttribute(1, 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, colour));
+		}
+		else if (layout == VertexLayout::Packed) {
+			// Normalized, so the shader still sees floats (z defaults to 0)
+			vertBuffer.setAttribute(0, 2, GL_SHORT, sizeof(PackedVertex), offsetof(PackedVertex, position), GL_TRUE);
+			vertBuffer.setAttribute(1, 4, GL_UNSIGNED_BYTE, sizeof(PackedVertex), offsetof(PackedVertex, colour), GL_TRUE);
+		}
+		else {
+			vertBuffer.setAttribute(0, 3, GL_FLOAT, 0, 0);
+			colorsBuffer->setAttribute(1, 3, GL_FLOAT, 0, 0);
+		}
+	}
+
+	// Longest a map waits on the GPU in one go, in nanoseconds
+	constexpr GLuint64 FENCE_TIMEOUT = 1000000000;
+
+	// glBufferStorage is only core from OpenGL 4.4, the 4.6 build asks for a 4.3 context
+	bool hasBufferStorage() {
+#ifdef USE_OPENGL_4_6
+		return GLAD_GL_VERSION_4_4 != 0;
+#else
+		return false;
+#endif
+	}
+}
+
+
+PackedVertex packVertex(const glm::vec3& position, const glm::vec3& colour) {
+	PackedVertex packed;
+	packed.position = glm::packSnorm<glm::int16>(glm::vec2(position)); // Clamped to [-1, 1]
+	packed.colour = glm::packUnorm<glm::uint8>(glm::vec4(colour, 1.f)); // Clamped to [0, 1]
+	return packed;
+}
+
+
+TriangleInstance makeTriangleInstance(const glm::vec3& offset, const glm::vec3& colour) {
+	TriangleInstance instance;
+	instance.offset = glm::vec2(offset);
+	instance.colour = glm::packUnorm<glm::uint8>(glm::vec4(colour, 1.f)); // Clamped to [0, 1]
+	return instance;
+}
+
+
+GLuint colourCode(int depth, std::uint32_t path, int end) {
+	return (GLuint(depth) << (COLOUR_CODE_PATH_BITS + 1)) | (GLuint(path) << 1) | GLuint(end);
+}
+
+
+std::size_t vertexSize(VertexLayout layout) {
+	switch (layout) {
+	case VertexLayout::Interleaved: return sizeof(Vertex);
+	case VertexLayout::Packed: return sizeof(PackedVertex);
+	default: return sizeof(glm::vec3);
+	}
+}
+
+
+std::size_t countVertices(const CPU_Geometry& cpuGeom, VertexLayout layout) {
+	switch (layout) {
+	case VertexLayout::Interleaved: return cpuGeom.vertices.size();
+	case VertexLayout::Packed: return cpuGeom.packedVertices.size();
+	default: return cpuGeom.verts.size();
+	}
+}
+
+
+GPU_Geometry::GPU_Geometry(VertexLayout layout)
 	: vao()
-	, vertBuffer(0, 3, GL_FLOAT)
-	, colorsBuffer(1, 3, GL_FLOAT)
-{}
+	, vertBuffer()
+	, colorsBuffer()
+	, layout(layout)
+{
+	if (layout == VertexLayout::Separate) {
+		colorsBuffer.emplace(); // The other layouts keep the colours in vertBuffer
+	}
+	setVertexAttributes(layout, vertBuffer, colorsBuffer);
+}
 
 void GPU_Geometry::setVerts(const std::vector<glm::vec3>& verts) {
 	vertBuffer.uploadData(sizeof(glm::vec3) * verts.size(), verts.data(), GL_STATIC_DRAW);
 }
 
 void GPU_Geometry::setCols(const std::vector<glm::vec3>& cols) {
-	colorsBuffer.uploadData(sizeof(glm::vec3) * cols.size(), cols.data(), GL_STATIC_DRAW);
+	colorsBuffer->uploadData(sizeof(glm::vec3) * cols.size(), cols.data(), GL_STATIC_DRAW);
+}
+
+void GPU_Geometry::setVertices(const std::vector<Vertex>& vertices) {
+	vertBuffer.uploadData(sizeof(Vertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
+}
+
+void GPU_Geometry::updateVertices(std::size_t firstVertex, const std::vector<Vertex>& vertices) {
+	vertBuffer.updateData(sizeof(Vertex) * firstVertex, sizeof(Vertex) * vertices.size(), vertices.data());
+}
+
+void GPU_Geometry::setPackedVertices(const std::vector<PackedVertex>& packedVertices) {
+	vertBuffer.uploadData(sizeof(PackedVertex) * packedVertices.size(), packedVertices.data(), GL_STATIC_DRAW);
+}
+
+void GPU_Geometry::upload(const CPU_Geometry& cpuGeom) {
+	if (layout == VertexLayout::Interleaved) {
+		setVertices(cpuGeom.vertices);
+	}
+	else if (layout == VertexLayout::Packed) {
+		setPackedVertices(cpuGeom.packedVertices);
+	}
+	else {
+		setVerts(cpuGeom.verts);
+		setCols(cpuGeom.cols);
+	}
+}
+
+
+void GPU_Geometry::download(std::size_t vertexCount, CPU_Geometry& cpuGeom) const {
+	if (layout == VertexLayout::Interleaved) {
+		cpuGeom.vertices.resize(vertexCount);
+		vertBuffer.downloadData(0, sizeof(Vertex) * vertexCount, cpuGeom.vertices.data());
+	}
+	else if (layout == VertexLayout::Packed) {
+		cpuGeom.packedVertices.resize(vertexCount);
+		vertBuffer.downloadData(0, sizeof(PackedVertex) * vertexCount, cpuGeom.packedVertices.data());
+	}
+	else {
+		cpuGeom.verts.resize(vertexCount);
+		cpuGeom.cols.resize(vertexCount);
+		vertBuffer.downloadData(0, sizeof(glm::vec3) * vertexCount, cpuGeom.verts.data());
+		colorsBuffer->downloadData(0, sizeof(glm::vec3) * vertexCount, cpuGeom.cols.data());
+	}
+}
+
+
+void GPU_Geometry::reserve(std::size_t vertexCount) {
+	if (layout == VertexLayout::Interleaved) {
+		vertBuffer.uploadData(sizeof(Vertex) * vertexCount, nullptr, GL_DYNAMIC_COPY);
+	}
+	else if (layout == VertexLayout::Packed) {
+		vertBuffer.uploadData(sizeof(PackedVertex) * vertexCount, nullptr, GL_DYNAMIC_COPY);
+	}
+	else {
+		vertBuffer.uploadData(sizeof(glm::vec3) * vertexCount, nullptr, GL_DYNAMIC_COPY);
+		colorsBuffer->uploadData(sizeof(glm::vec3) * vertexCount, nullptr, GL_DYNAMIC_COPY);
+	}
+}
+
+void GPU_Geometry::bindRange(GLenum target, GLuint index, std::size_t firstVertex, std::size_t vertexCount) {
+	if (layout == VertexLayout::Interleaved) {
+		vertBuffer.bindRange(target, index, sizeof(Vertex) * firstVertex, sizeof(Vertex) * vertexCount);
+	}
+	else if (layout == VertexLayout::Packed) {
+		throw std::runtime_error("Packed vertices can only be uploaded.");
+	}
+	else {
+		vertBuffer.bindRange(target, index, sizeof(glm::vec3) * firstVertex, sizeof(glm::vec3) * vertexCount);
+		colorsBuffer->bindRange(target, index + 1, sizeof(glm::vec3) * firstVertex, sizeof(glm::vec3) * vertexCount);
+	}
+}
+
+
+//------------------------------------------------------------------------------
+
+
+void GPU_PyramidGeometry::upload(const CPU_Geometry& cpuGeom) {
+	geometry.upload(cpuGeom);
+	levels = cpuGeom.levels;
+}
+
+
+//------------------------------------------------------------------------------
+
+
+GPU_InstancedGeometry::GPU_InstancedGeometry()
+	: vao()
+	, shapeBuffer()
+	, instanceBuffer()
+{
+	shapeBuffer.setAttribute(0, 3, GL_FLOAT, 0, 0);
+	// Colour and offset advance once per instance
+	instanceBuffer.setInstanceAttribute(1, 4, GL_UNSIGNED_BYTE, sizeof(TriangleInstance), offsetof(TriangleInstance, colour), GL_TRUE);
+	instanceBuffer.setInstanceAttribute(2, 2, GL_FLOAT, sizeof(TriangleInstance), offsetof(TriangleInstance, offset));
+}
+
+void GPU_InstancedGeometry::setShape(const std::vector<glm::vec3>& verts) {
+	shapeBuffer.uploadData(sizeof(glm::vec3) * verts.size(), verts.data(), GL_STATIC_DRAW);
+}
+
+void GPU_InstancedGeometry::setInstances(const std::vector<TriangleInstance>& instances) {
+	instanceBuffer.uploadData(sizeof(TriangleInstance) * instances.size(), instances.data(), GL_STATIC_DRAW);
+}
+
+void GPU_InstancedGeometry::upload(const CPU_Geometry& cpuGeom) {
+	setShape(cpuGeom.verts);
+	setInstances(cpuGeom.instances);
+}
+
+
+//------------------------------------------------------------------------------
+
+
+void setColourTableUniforms(const ColourTable& colourTable, GLuint program) {
+	const std::vector<ColourStep>& steps = colourTable.steps;
+	if (steps.size() > MAX_COLOUR_STEPS) {
+		throw std::runtime_error("Colour table does not fit the shader.");
+	}
+
+	// Uniform arrays are set one member array at a time
+	std::vector<glm::vec2> mixes(steps.size());
+	std::vector<glm::vec3> offsets(steps.size());
+	std::vector<glm::vec4> overrides(steps.size());
+	for (std::size_t i = 0; i < steps.size(); i++) {
+		mixes[i] = steps[i].mix;
+		offsets[i] = steps[i].offset;
+		overrides[i] = steps[i].override;
+	}
+
+	glUseProgram(program);
+	if (!steps.empty()) {
+		GLsizei count = GLsizei(steps.size());
+		glUniform2fv(glGetUniformLocation(program, "colourMix"), count, &mixes[0][0]);
+		glUniform3fv(glGetUniformLocation(program, "colourOffset"), count, &offsets[0][0]);
+		glUniform4fv(glGetUniformLocation(program, "colourOverride"), count, &overrides[0][0]);
+	}
+	glUniform3fv(glGetUniformLocation(program, "baseColours"), 2, &colourTable.baseColours[0][0]);
+	glUniform1i(glGetUniformLocation(program, "branching"), colourTable.branching);
+}
+
+
+//------------------------------------------------------------------------------
+
+
+GPU_HierarchyGeometry::GPU_HierarchyGeometry()
+	: vao()
+	, baseBuffer(0, 3, GL_FLOAT)
+{}
+
+void GPU_HierarchyGeometry::upload(const CPU_Geometry& cpuGeom, GLuint program) {
+	const std::vector<glm::mat3>& transforms = cpuGeom.hierarchy.transforms;
+	if (transforms.size() > MAX_COLOUR_STEPS) {
+		throw std::runtime_error("Hierarchy does not fit the hierarchy shader.");
+	}
+
+	baseBuffer.uploadData(sizeof(glm::vec3) * cpuGeom.verts.size(), cpuGeom.verts.data(), GL_STATIC_DRAW);
+
+	hierarchy.branching = cpuGeom.hierarchy.branching;
+	hierarchy.depth = cpuGeom.hierarchy.depth;
+	hierarchy.allLevels = cpuGeom.hierarchy.allLevels;
+
+	setColourTableUniforms(cpuGeom.colourTable, program);
+	if (!transforms.empty()) {
+		glUniformMatrix3fv(glGetUniformLocation(program, "transforms"), GLsizei(transforms.size()), GL_FALSE, &transforms[0][0][0]);
+	}
+}
+
+void GPU_HierarchyGeometry::draw(GLuint program) {
+	GLint depthLocation = glGetUniformLocation(program, "depth");
+
+	// Levels are drawn one at a time, so the shader can tell the level from the uniform
+	GLsizei instanceCount = 1;
+	for (int level = 0; level <= hierarchy.depth; level++) {
+		if (hierarchy.allLevels || level == hierarchy.depth) {
+			glUniform1i(depthLocation, level);
+			glDrawArraysInstanced(GL_LINES, 0, 2, instanceCount);
+		}
+		instanceCount *= hierarchy.branching;
+	}
+}
+
+
+//------------------------------------------------------------------------------
+
+
+GPU_IndexedGeometry::GPU_IndexedGeometry()
+	: vao()
+	, vertBuffer()
+	, indexBuffer()
+{
+	vertBuffer.setAttribute(0, 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, position));
+	vertBuffer.setAttribute(1, 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, colour));
+}
+
+void GPU_IndexedGeometry::upload(const CPU_Geometry& cpuGeom) {
+	vao.bind(); // The index buffer binding belongs to the VAO
+	vertBuffer.uploadData(sizeof(Vertex) * cpuGeom.vertices.size(), cpuGeom.vertices.data(), GL_STATIC_DRAW);
+
+	if (!cpuGeom.shortIndices.empty()) {
+		indexBuffer.uploadData(sizeof(GLushort) * cpuGeom.shortIndices.size(), cpuGeom.shortIndices.data(), GL_STATIC_DRAW);
+		indexType = GL_UNSIGNED_SHORT;
+		indexCount = GLsizei(cpuGeom.shortIndices.size());
+	}
+	else {
+		indexBuffer.uploadData(sizeof(GLuint) * cpuGeom.indices.size(), cpuGeom.indices.data(), GL_STATIC_DRAW);
+		indexType = GL_UNSIGNED_INT;
+		indexCount = GLsizei(cpuGeom.indices.size());
+	}
+}
+
+
+//------------------------------------------------------------------------------
+
+
+GPU_CodedGeometry::GPU_CodedGeometry()
+	: vao()
+	, vertBuffer()
+{
+	vertBuffer.setAttribute(0, 2, GL_FLOAT, sizeof(CodedVertex), offsetof(CodedVertex, position));
+	vertBuffer.setIntegerAttribute(1, 1, GL_UNSIGNED_INT, sizeof(CodedVertex), offsetof(CodedVertex, code));
+}
+
+void GPU_CodedGeometry::upload(const CPU_Geometry& cpuGeom, GLuint program) {
+	vertBuffer.uploadData(sizeof(CodedVertex) * cpuGeom.codedVertices.size(), cpuGeom.codedVertices.data(), GL_STATIC_DRAW);
+	setColourTableUniforms(cpuGeom.colourTable, program);
+}
+
+
+//------------------------------------------------------------------------------
+
+
+GPU_MappedGeometry::GPU_MappedGeometry(VertexLayout layout)
+	: slots()
+	, layout(layout)
+	, persistent(hasBufferStorage())
+{
+	for (Slot& slot : slots) {
+		slot.vao.bind();
+		if (layout == VertexLayout::Separate) {
+			slot.colorsBuffer.emplace();
+		}
+		setVertexAttributes(layout, slot.vertBuffer, slot.colorsBuffer);
+	}
+}
+
+VertexDestination GPU_MappedGeometry::map(std::size_t vertexCount) {
+	writing = (current + 1) % SLOT_COUNT;
+	Slot& slot = slots[writing];
+
+	// Nothing may still be reading the slot. Flushing makes sure the fence gets to the GPU at all
+	if (slot.fence) {
+		while (glClientWaitSync(*slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT) == GL_TIMEOUT_EXPIRED) {}
+		slot.fence.reset();
+	}
+
+	bool separate = layout == VertexLayout::Separate;
+	if (vertexCount > slot.capacity) {
+		slot.capacity = std::max(vertexCount, 2 * slot.capacity); // Grow geometrically, like std::vector
+		if (persistent) {
+			allocatePersistent(slot);
+		}
+		else {
+			slot.vertBuffer.uploadData(vertexSize(layout) * slot.capacity, nullptr, GL_STREAM_DRAW);
+			if (separate) {
+				slot.colorsBuffer->uploadData(sizeof(glm::vec3) * slot.capacity, nullptr, GL_STREAM_DRAW);
+			}
+		}
+	}
+
+	if (!persistent) {
+		// The GPU is done with the slot, so the driver neither has to wait nor keep the old contents
+		GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+		slot.mappedVertices = slot.vertBuffer.map(0, vertexSize(layout) * vertexCount, access);
+		if (separate) {
+			slot.mappedColours = slot.colorsBuffer->map(0, sizeof(glm::vec3) * vertexCount, access);
+		}
+	}
+	return { layout, slot.mappedVertices, separate ? static_cast<glm::vec3*>(slot.mappedColours) : nullptr };
+}
+
+bool GPU_MappedGeometry::unmap() {
+	bool intact = unmapWriting();
+	current = writing;
+	return intact;
+}
+
+void GPU_MappedGeometry::abandon() {
+	unmapWriting();
+}
+
+bool GPU_MappedGeometry::unmapWriting() {
+	// Persistent coherent mappings stay as they are, writes show up in the commands issued after them
+	bool intact = true;
+	if (!persistent) {
+		Slot& slot = slots[writing];
+		intact = slot.vertBuffer.unmap();
+		if (layout == VertexLayout::Separate) {
+			intact = slot.colorsBuffer->unmap() && intact;
+		}
+	}
+	return intact;
+}
+
+void GPU_MappedGeometry::fence() {
+	slots[current].fence.emplace();
+}
+
+void GPU_MappedGeometry::allocatePersistent(Slot& slot) {
+#ifdef USE_OPENGL_4_6
+	// Immutable storage cannot grow, so it is replaced, and stays mapped for as long as it lives
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	slot.vao.bind();
+	slot.vertBuffer = VertexBuffer();
+	slot.vertBuffer.allocateStorage(vertexSize(layout) * slot.capacity, flags);
+	slot.mappedVertices = slot.vertBuffer.map(0, vertexSize(layout) * slot.capacity, flags);
+	if (layout == VertexLayout::Separate) {
+		slot.colorsBuffer.emplace();
+		slot.colorsBuffer->allocateStorage(sizeof(glm::vec3) * slot.capacity, flags);
+		slot.mappedColours = slot.colorsBuffer->map(0, sizeof(glm::vec3) * slot.capacity, flags);
+	}
+	setVertexAttributes(layout, slot.vertBuffer, slot.colorsBuffer);
+#endif
 }
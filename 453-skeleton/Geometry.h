@@ -6,39 +6,389 @@
 // similar classes with the needed functionality
 //------------------------------------------------------------------------------
 
+#include "IndexBuffer.h"
 #include "VertexArray.h"
 #include "VertexBuffer.h"
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 
+// Position and colour of one vertex, stored next to each other
+struct Vertex {
+	glm::vec3 position;
+	glm::vec3 colour;
+};
+
+
+// Compact form of Vertex, 8 bytes instead of 24. The fractals lie in the z = 0 plane
+// inside [-1, 1], so x and y are stored as 16 bit normalized integers and z is dropped
+struct PackedVertex {
+	glm::i16vec2 position; // 16 bit snorm
+	glm::u8vec4 colour; // RGBA8 unorm, alpha is always 1
+};
+
+PackedVertex packVertex(const glm::vec3& position, const glm::vec3& colour);
+
+
+// One copy of a shared shape (the leaf triangle of the Sierpinski Triangle), 12 bytes
+// instead of the 72 of its three vertices. The shape lies in the z = 0 plane
+struct TriangleInstance {
+	glm::vec2 offset; // Added to every vertex of the shape
+	glm::u8vec4 colour; // RGBA8 unorm, alpha is always 1
+};
+
+TriangleInstance makeTriangleInstance(const glm::vec3& offset, const glm::vec3& colour);
+
+
+// How the colours of a primitive change from a parent to one of its children. The child's end
+// colours are mix(parent colour A, parent colour B, mix[end]) + offset, then mixed towards
+// override.rgb by override.a (triangles only use end A)
+struct ColourStep {
+	glm::vec2 mix;
+	glm::vec3 offset;
+	glm::vec4 override;
+};
+
+// Colours of a self-similar figure, worked out on the GPU by walking down from the colours at the
+// ends of the initial primitive
+struct ColourTable {
+	int branching = 0; // Children per primitive
+	glm::vec3 baseColours[2];
+	std::vector<ColourStep> steps; // One per level and child, steps[level * branching + child]
+};
+
+// Most steps the hierarchy and coded shaders have room for (MAX_STEPS in hierarchy.vert and coded.vert)
+constexpr int MAX_COLOUR_STEPS = 40;
+
+// A figure drawn by composing transforms on the GPU, starting from the base line in verts.
+// Its colours are in the colourTable of the geometry
+struct CPU_Hierarchy {
+	int branching = 0; // Children per line, 0 when the geometry is not hierarchical
+	int depth = 0;
+	bool allLevels = false; // Draw every level up to depth, not just the deepest
+	std::vector<glm::mat3> transforms; // 2D affine transforms, in the frame of the parent, laid out like ColourTable::steps
+};
+
+
+// Where a vertex sits in its figure, instead of its colour: the number of levels below the
+// initial primitive, the child taken at each of them (as base branching digits, most significant
+// first) and which end of the line it is (always 0 for triangles)
+struct CodedVertex {
+	glm::vec2 position; // The figures lie in the z = 0 plane
+	GLuint code; // depth << 27 | path << 1 | end
+};
+
+constexpr int COLOUR_CODE_PATH_BITS = 26;
+
+GLuint colourCode(int depth, std::uint32_t path, int end);
+
+
+// How vertex attributes are laid out in memory
+enum class VertexLayout {
+	Separate, // One array (and VBO) per attribute
+	Interleaved, // One array (and VBO) of Vertex
+	Packed // One array (and VBO) of PackedVertex
+};
+
+// Bytes per vertex in the array (or first array, for VertexLayout::Separate) of a layout
+std::size_t vertexSize(VertexLayout layout);
+
+
+// Memory a generator writes vertices straight into, such as a mapped buffer (see GPU_MappedGeometry)
+struct VertexDestination {
+	VertexLayout layout = VertexLayout::Separate;
+	void* vertices = nullptr; // Positions, Vertex or PackedVertex, depending on layout
+	glm::vec3* colours = nullptr; // Only used for VertexLayout::Separate
+};
+
+
+// Where one iteration is in vertices holding several of them (see CPU_Geometry::levels)
+struct LevelRange {
+	GLint first = 0;
+	GLsizei count = 0;
+};
+
+
+// What a generator wrote into a CPU_Geometry, and so which of its members are used
+enum class GeometryKind {
+	Vertices, // verts and cols, vertices or packedVertices, depending on the layout
+	Instances, // verts holds one shape that is drawn once per instance
+	Hierarchy, // verts holds the base line of hierarchy, coloured by colourTable
+	Indexed, // The vertices are shared, indices or shortIndices list the primitives made of them
+	Coded, // codedVertices, coloured by colourTable
+	Levels // The vertices hold every iteration one after another, levels[n] is iteration n
+};
+
+
 // List of vertices and texture coordinates using std::vector and glm::vec3
 struct CPU_Geometry {
+	GeometryKind kind = GeometryKind::Vertices;
 	std::vector<glm::vec3> verts;
 	std::vector<glm::vec3> cols;
+	std::vector<Vertex> vertices; // Used instead of verts and cols for VertexLayout::Interleaved
+	std::vector<PackedVertex> packedVertices; // Used instead of verts and cols for VertexLayout::Packed
+	std::vector<TriangleInstance> instances; // GeometryKind::Instances
+	CPU_Hierarchy hierarchy; // GeometryKind::Hierarchy
+	std::vector<CodedVertex> codedVertices; // GeometryKind::Coded, used instead of verts and cols
+	ColourTable colourTable; // Colours of hierarchy and codedVertices
+	std::vector<LevelRange> levels; // GeometryKind::Levels
+
+	// GeometryKind::Indexed. The largest value of the index type is never a vertex, it restarts line strips
+	std::vector<GLuint> indices;
+	std::vector<GLushort> shortIndices; // Used instead of indices when every vertex number fits in 16 bits
 };
 
+// Number of vertices held in the given layout
+std::size_t countVertices(const CPU_Geometry& cpuGeom, VertexLayout layout);
 
-// VAO and two VBOs for storing vertices and texture coordinates, respectively
+
+// VAO and two VBOs for storing vertices and texture coordinates, respectively.
+// With VertexLayout::Interleaved or VertexLayout::Packed both attributes come from vertBuffer instead,
+// and there is no colorsBuffer
 class GPU_Geometry {
 public:
-	GPU_Geometry();
+	GPU_Geometry(VertexLayout layout = VertexLayout::Separate);
 	// Public interface
 	void bind() {
 		vao.bind();
 	}
+	VertexLayout getLayout() const { return layout; }
+
+	// VertexLayout::Separate
 	void setVerts(const std::vector<glm::vec3>& verts);
 	void setCols(const std::vector<glm::vec3>& cols);
+
+	// VertexLayout::Interleaved, a single upload
+	void setVertices(const std::vector<Vertex>& vertices);
+
+	// VertexLayout::Interleaved, overwrites vertices starting at firstVertex. They have to fit in
+	// what an earlier upload or reserve allocated
+	void updateVertices(std::size_t firstVertex, const std::vector<Vertex>& vertices);
+
+	// VertexLayout::Packed, a single upload of a third of the size
+	void setPackedVertices(const std::vector<PackedVertex>& packedVertices);
+
+	// Uploads whichever arrays of cpuGeom match the layout
+	void upload(const CPU_Geometry& cpuGeom);
+
+	// Reads the first vertexCount vertices back into whichever arrays of cpuGeom match the layout,
+	// to check what transform feedback or a compute shader wrote. Waits for the GPU
+	void download(std::size_t vertexCount, CPU_Geometry& cpuGeom) const;
+
+	// Makes room for vertexCount vertices without uploading any, for transform feedback to fill in
+	void reserve(std::size_t vertexCount);
+
+	// Binds vertexCount vertices starting at firstVertex to an indexed target, for transform feedback
+	// or compute shaders to write: positions and colours to bindings index and index + 1 for
+	// VertexLayout::Separate, or interleaved to binding index.
+	// Throws std::runtime_error for VertexLayout::Packed, which neither can write
+	void bindRange(GLenum target, GLuint index, std::size_t firstVertex, std::size_t vertexCount);
 protected:
 	// note: due to how OpenGL works, vao needs to be
 // defined and initialized before the vertex buffers
 	VertexArray vao;
 
 	VertexBuffer vertBuffer;
-	VertexBuffer colorsBuffer;
+	std::optional<VertexBuffer> colorsBuffer; // VertexLayout::Separate only
 private:
+	VertexLayout layout;
+
+};
+
+
+// A GPU_Geometry holding every iteration of a scene one after another, and where each of them is.
+// Once uploaded, switching iteration only changes the range drawn, nothing is generated or uploaded
+class GPU_PyramidGeometry {
+public:
+	GPU_PyramidGeometry(VertexLayout layout = VertexLayout::Separate) : geometry(layout) {}
+	// Public interface
+	void bind() {
+		geometry.bind();
+	}
+
+	// Uploads the vertices of cpuGeom and keeps its levels
+	void upload(const CPU_Geometry& cpuGeom);
+
+	// Iterations 0 up to levelCount() - 1 are resident
+	int levelCount() const { return int(levels.size()); }
+	LevelRange level(int iteration) const { return levels[iteration]; }
+private:
+	GPU_Geometry geometry;
+	std::vector<LevelRange> levels;
+};
+
+
+// VAO with one VBO holding a single shape and another holding one TriangleInstance per copy
+// of it, for drawing with glDrawArraysInstanced
+class GPU_InstancedGeometry {
+public:
+	GPU_InstancedGeometry();
+	// Public interface
+	void bind() {
+		vao.bind();
+	}
+
+	void setShape(const std::vector<glm::vec3>& verts);
+	void setInstances(const std::vector<TriangleInstance>& instances);
+
+	// Uploads verts as the shape and instances
+	void upload(const CPU_Geometry& cpuGeom);
+protected:
+	VertexArray vao;
+
+	VertexBuffer shapeBuffer;
+	VertexBuffer instanceBuffer;
+};
+
+
+// Puts a ColourTable into the uniforms of program (which is left in use).
+// Throws std::runtime_error if there are more than MAX_COLOUR_STEPS steps
+void setColourTableUniforms(const ColourTable& colourTable, GLuint program);
+
+
+// VAO with one VBO holding the base line of a CPU_Hierarchy. The transforms and colours are kept
+// in the uniforms of a program using hierarchy.vert
+class GPU_HierarchyGeometry {
+public:
+	GPU_HierarchyGeometry();
+	// Public interface
+	void bind() {
+		vao.bind();
+	}
+
+	// Uploads the base line and, into program (which is left in use), the transforms and colours.
+	// Throws std::runtime_error if there are more than MAX_COLOUR_STEPS of them
+	void upload(const CPU_Geometry& cpuGeom, GLuint program);
+
+	// Draws one instance of the base line per leaf (or per line of every level, for allLevels)
+	void draw(GLuint program);
+protected:
+	VertexArray vao;
+
+	VertexBuffer baseBuffer;
+private:
+	CPU_Hierarchy hierarchy; // Without the transforms, which are already on the GPU
+};
+
+
+// VAO with one VBO of interleaved Vertex and an index buffer, for drawing with glDrawElements
+class GPU_IndexedGeometry {
+public:
+	GPU_IndexedGeometry();
+	// Public interface
+	void bind() {
+		vao.bind();
+	}
+	GLenum getIndexType() const { return indexType; }
+	GLsizei getIndexCount() const { return indexCount; }
+	GLuint getRestartIndex() const { return (indexType == GL_UNSIGNED_SHORT) ? 0xFFFF : 0xFFFFFFFF; }
+
+	// Uploads vertices and whichever of indices and shortIndices is in use
+	void upload(const CPU_Geometry& cpuGeom);
+protected:
+	VertexArray vao;
+
+	VertexBuffer vertBuffer;
+	IndexBuffer indexBuffer;
+private:
+	GLenum indexType = GL_UNSIGNED_INT;
+	GLsizei indexCount = 0;
+};
+
+
+// VAO with one VBO of CodedVertex. The colour table is kept in the uniforms of a program using coded.vert
+class GPU_CodedGeometry {
+public:
+	GPU_CodedGeometry();
+	// Public interface
+	void bind() {
+		vao.bind();
+	}
+
+	// Uploads codedVertices and, into program (which is left in use), the colour table
+	void upload(const CPU_Geometry& cpuGeom, GLuint program);
+protected:
+	VertexArray vao;
+
+	VertexBuffer vertBuffer;
+};
+
+
+// An empty VAO. Core profile draws need one bound, even when the vertex shader makes up every
+// vertex itself from gl_VertexID (procedural.vert)
+class GPU_ProceduralGeometry {
+public:
+	// Public interface
+	void bind() {
+		vao.bind();
+	}
+protected:
+	VertexArray vao;
+};
+
+
+// A ring of VAOs and VBO(s) that generators write into directly, instead of into a CPU_Geometry
+// that is then copied by an upload. map() hands out the next slot, unmap() makes it the one bind()
+// draws from, and fence() marks the end of each draw of it. A slot is only written again once its
+// last draw has finished, which with three of them has almost always happened already.
+// Only map(), unmap() and abandon() need the thread of the context, the mapped memory can be
+// written from any thread in between (see GenerationWorker::requestInto).
+// With the OpenGL 4.6 build on a 4.4 or newer context the VBO(s) are persistently mapped storage,
+// mapped once whenever they grow. Otherwise every map() is a glMapBufferRange that neither waits on
+// the GPU nor keeps the old contents
+class GPU_MappedGeometry {
+public:
+	GPU_MappedGeometry(VertexLayout layout = VertexLayout::Separate);
+	// Public interface
+	void bind() {
+		slots[current].vao.bind();
+	}
+	VertexLayout getLayout() const { return layout; }
+
+	// Room for vertexCount vertices in the next slot, growing its VBO(s) if needed.
+	// Throws std::runtime_error if the driver cannot map them
+	VertexDestination map(std::size_t vertexCount);
+
+	// Finishes writing the mapped slot and makes it current. Returns false if the driver lost
+	// what was written (it can, with the glMapBufferRange maps) and the slot needs writing again
+	bool unmap();
+
+	// Finishes writing the mapped slot without making it current, when what was written is not wanted
+	void abandon();
+
+	// Call after drawing the current slot
+	void fence();
+private:
+	static constexpr int SLOT_COUNT = 3;
+
+	struct Slot {
+		// note: due to how OpenGL works, vao needs to be
+		// defined and initialized before the vertex buffers
+		VertexArray vao;
+
+		VertexBuffer vertBuffer;
+		std::optional<VertexBuffer> colorsBuffer; // VertexLayout::Separate only
+		std::size_t capacity = 0; // In vertices
+		std::optional<FenceHandle> fence; // Passed by the GPU once the last draw from the slot is done
+		void* mappedVertices = nullptr; // Persistent mappings, if persistent
+		void* mappedColours = nullptr;
+	};
+
+	std::array<Slot, SLOT_COUNT> slots;
+	int current = 0; // Drawn by bind()
+	int writing = 0; // Handed out by map()
+	VertexLayout layout;
+	bool persistent; // Whether the slots are persistently mapped storage
 
+	// Replaces the VBO(s) of slot with persistently mapped storage of its capacity
+	void allocatePersistent(Slot& slot);
+	bool unmapWriting();
 };
@@ -0,0 +1,80 @@
+#include "GeometryCache.h"
+
+#include <algorithm>
+
+
+namespace {
+
+	template <typename T>
+	std::size_t bytesOf(const std::vector<T>& values) {
+		return values.size() * sizeof(T);
+	}
+
+	std::size_t cpuBytes(const CPU_Geometry& cpuGeom) {
+		return bytesOf(cpuGeom.verts) + bytesOf(cpuGeom.cols) + bytesOf(cpuGeom.vertices) + bytesOf(cpuGeom.packedVertices)
+			+ bytesOf(cpuGeom.instances) + bytesOf(cpuGeom.hierarchy.transforms) + bytesOf(cpuGeom.codedVertices)
+			+ bytesOf(cpuGeom.colourTable.steps) + bytesOf(cpuGeom.indices) + bytesOf(cpuGeom.shortIndices) + bytesOf(cpuGeom.levels);
+	}
+
+	std::size_t gpuBytes(const CPU_Geometry& cpuGeom, VertexLayout layout) {
+		std::size_t perVertex = (layout == VertexLayout::Separate) ? 2 * sizeof(glm::vec3) : vertexSize(layout);
+		return countVertices(cpuGeom, layout) * perVertex;
+	}
+}
+
+
+GeometryCache::GeometryCache(VertexLayout layout, std::size_t budget)
+	: layout(layout)
+	, budget(budget)
+{}
+
+
+CachedGeometry* GeometryCache::find(const FractalRequest& request) {
+	auto entry = std::find_if(entries.begin(), entries.end(), [&](const CachedGeometry& cached) { return cached.generated.request == request; });
+	if (entry == entries.end()) {
+		return nullptr;
+	}
+	entries.splice(entries.begin(), entries, entry); // Moves the node, so pointers to it stay valid
+	return &entries.front();
+}
+
+
+bool GeometryCache::contains(const FractalRequest& request) const {
+	return std::any_of(entries.begin(), entries.end(), [&](const CachedGeometry& cached) { return cached.generated.request == request; });
+}
+
+
+CachedGeometry* GeometryCache::insert(const GeneratedGeometry& generated, bool upload) {
+	// Generated again (a prefetch that was also requested, for example), the copies there are just as good
+	if (CachedGeometry* cached = find(generated.request)) {
+		return cached;
+	}
+
+	std::size_t bytes = cpuBytes(generated.cpuGeom) + (upload ? gpuBytes(generated.cpuGeom, layout) : 0);
+	if (bytes > budget) {
+		return nullptr;
+	}
+
+	// Evict from the least recently used end, stepping over the pinned entry
+	auto entry = entries.end();
+	while (used + bytes > budget && entry != entries.begin()) {
+		--entry;
+		if (&*entry != pinned) {
+			used -= entry->bytes;
+			entry = entries.erase(entry);
+		}
+	}
+	if (used + bytes > budget) {
+		return nullptr; // Only the pinned entry is left, and the two do not fit together
+	}
+
+	CachedGeometry& cached = entries.emplace_front();
+	cached.generated = generated;
+	if (upload) {
+		cached.gpuGeom.emplace(layout);
+		cached.gpuGeom->upload(generated.cpuGeom);
+	}
+	cached.bytes = bytes;
+	used += bytes;
+	return &cached;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a cache of generated fractals, so going back to a scene,
+// iteration or view that has been shown (or prefetched) before needs neither
+// generating nor uploading again.
+//
+// Entries are looked up by their FractalRequest, which holds the scene, the
+// iteration and the view. Each keeps the CPU copy of the result and, for plain
+// vertices, a GPU copy that is drawn from directly. The other results are
+// uploaded again from the CPU copy, as they set uniforms of their programs.
+// Together the entries stay within a byte budget, the least recently used ones
+// are evicted first.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "GenerationWorker.h"
+#include "Geometry.h"
+
+#include <cstddef>
+#include <list>
+#include <optional>
+
+
+// Default budget, counting both copies
+constexpr std::size_t DEFAULT_CACHE_BYTES = std::size_t(256) << 20;
+
+
+struct CachedGeometry {
+	GeneratedGeometry generated; // CPU copy
+	std::optional<GPU_Geometry> gpuGeom; // GPU copy, of plain vertices only
+	std::size_t bytes = 0; // Of both copies
+};
+
+
+class GeometryCache {
+
+public:
+	GeometryCache(VertexLayout layout, std::size_t budget = DEFAULT_CACHE_BYTES);
+
+	// Disallow copying and moving, pointers to the entries are handed out
+	GeometryCache(const GeometryCache&) = delete;
+	GeometryCache operator=(const GeometryCache&) = delete;
+
+	// The entry for request, which becomes the most recently used, or nullptr
+	CachedGeometry* find(const FractalRequest& request);
+
+	// Whether there is an entry for request, without using it
+	bool contains(const FractalRequest& request) const;
+
+	// Adds a copy of generated as the most recently used entry, uploading its vertices into a GPU copy
+	// if upload is set (they have to be plain vertices in the layout of the cache). Evicts the least
+	// recently used entries until everything fits in the budget. Returns nullptr, and adds nothing, if
+	// generated alone does not fit. If its request is cached already, that entry is returned instead,
+	// and becomes the most recently used
+	CachedGeometry* insert(const GeneratedGeometry& generated, bool upload);
+
+	// The entry being drawn from is never evicted
+	void pin(const CachedGeometry* entry) { pinned = entry; }
+
+	std::size_t usedBytes() const { return used; }
+
+private:
+	VertexLayout layout;
+	std::size_t budget;
+	std::size_t used = 0;
+	std::list<CachedGeometry> entries; // Most recently used first
+	const CachedGeometry* pinned = nullptr;
+};
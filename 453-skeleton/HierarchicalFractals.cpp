@@ -0,0 +1,77 @@
+#include "HierarchicalFractals.h"
+
+#include "CodedFractals.h"
+
+#include <stdexcept>
+
+
+namespace {
+
+	// Affine transform taking (0, 0) to a and (1, 0) to b, with the y axis turned the same way
+	glm::mat3 lineFrame(const glm::vec3& a, const glm::vec3& b) {
+		glm::vec2 along(b - a);
+		glm::vec2 across(-along.y, along.x);
+		return glm::mat3(glm::vec3(along, 0.f), glm::vec3(across, 0.f), glm::vec3(glm::vec2(a), 1.f));
+	}
+
+	// Transform that maps parent onto child, in the frame of parent
+	glm::mat3 childTransform(const glm::vec3& parentA, const glm::vec3& parentB, const glm::vec3& childA, const glm::vec3& childB) {
+		return lineFrame(childA, childB) * glm::inverse(lineFrame(parentA, parentB));
+	}
+
+	void prepare(CPU_Geometry& cpuGeom, int branching, int iteration, bool allLevels) {
+		if (iteration * branching > MAX_COLOUR_STEPS) {
+			throw std::runtime_error("Too many iterations for the hierarchy shader.");
+		}
+		cpuGeom.verts.clear();
+		cpuGeom.cols.clear();
+		cpuGeom.hierarchy.branching = branching;
+		cpuGeom.hierarchy.depth = iteration;
+		cpuGeom.hierarchy.allLevels = allLevels;
+		cpuGeom.hierarchy.transforms.clear();
+	}
+}
+
+
+/*
+* Creates the base line, transforms and colour table of the Levy C Curve
+*
+* @param line	Initial line
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param cpuGeom	Collection of vectors for geometry
+*
+*/
+void levyCCurveCreateHierarchy(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom) {
+	prepare(cpuGeom, 2, iteration, false);
+	cpuGeom.verts = { line.A, line.B };
+	levyColourTable(line, iteration, totalIterations, cpuGeom.colourTable);
+
+	for (int level = 0; level < iteration; level++) {
+		for (const LevyCCurve& child : line.subdivide(iteration - level, totalIterations)) {
+			cpuGeom.hierarchy.transforms.push_back(childTransform(line.A, line.B, child.A, child.B));
+		}
+	}
+}
+
+
+/*
+* Creates the base line, transforms and colour table of the Tree scene
+*
+* @param branch		Tree trunk
+* @param iteration	Number of iterations to generate
+* @param iterationCounter	tracks number of iterations completed to detect when to start creating leaves
+* @param cpuGeom	Collection of vectors for geometry
+*
+*/
+void treeCreateHierarchy(const Tree& branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom) {
+	prepare(cpuGeom, 3, iteration, true);
+	cpuGeom.verts = { branch.base, branch.top };
+	treeColourTable(branch, iteration, iterationCounter, cpuGeom.colourTable);
+
+	for (int level = 0; level < iteration; level++) {
+		for (const Tree& child : branch.grow(iterationCounter + level + 1)) {
+			cpuGeom.hierarchy.transforms.push_back(childTransform(branch.base, branch.top, child.base, child.top));
+		}
+	}
+}
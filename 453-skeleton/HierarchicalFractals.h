@@ -0,0 +1,21 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains generators that describe the Levy C Curve and the Tree as
+// a hierarchy of transforms instead of listing their lines.
+//
+// Both figures are self-similar: every child line is the same similarity
+// transform of its parent, whatever the parent is. So the whole figure is one
+// base line plus, for every level, one transform (and colour rule) per child
+// (see CPU_Hierarchy). The GPU composes those per instance, so the generated
+// data grows with the number of iterations instead of 2^n or 3^n.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+
+// Replace the contents of cpuGeom with the base line (in verts), the hierarchy and its colour table.
+// Throw std::runtime_error if the hierarchy needs more than MAX_COLOUR_STEPS transforms
+void levyCCurveCreateHierarchy(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom);
+void treeCreateHierarchy(const Tree& branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom);
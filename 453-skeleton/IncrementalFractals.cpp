@@ -0,0 +1,251 @@
+#include "IncrementalFractals.h"
+
+#include <utility>
+
+
+namespace {
+
+	// Copies the first vertexCount vertices (reusing cpuGeom's capacity)
+	void copyPrefix(const CPU_Geometry& from, std::size_t vertexCount, CPU_Geometry& to) {
+		to.verts.assign(from.verts.begin(), from.verts.begin() + vertexCount);
+		to.cols.assign(from.cols.begin(), from.cols.begin() + vertexCount);
+	}
+}
+
+
+bool FractalRefiner::generate(const FractalRequest& request, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	if (request.sceneNumber != residentScene) {
+		clear();
+		residentScene = request.sceneNumber;
+	}
+	bool (FractalRefiner::*refine)(int, CPU_Geometry&, const std::atomic<bool>*) = fractalScene(request.sceneNumber).incremental;
+	return (this->*refine)(request.iteration, cpuGeom, cancelled) && !isCancelled(cancelled);
+}
+
+
+bool FractalRefiner::generateSierpinski(int iteration, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	while (int(sierpinskiLevels.size()) <= iteration) {
+		if (!refineSierpinski(cancelled)) {
+			return false;
+		}
+	}
+	const CPU_Geometry& level = sierpinskiLevels[iteration].cpuGeom;
+	copyPrefix(level, level.verts.size(), cpuGeom);
+	return true;
+}
+
+
+bool FractalRefiner::generateLevy(int iteration, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	while (int(levyLevels.size()) <= iteration) {
+		if (!refineLevy(cancelled)) {
+			return false;
+		}
+	}
+	const CPU_Geometry& level = levyLevels[iteration].cpuGeom;
+	copyPrefix(level, level.verts.size(), cpuGeom);
+	return true;
+}
+
+
+bool FractalRefiner::generateTree(int iteration, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	while (treeDepth < iteration) {
+		if (!refineTree(cancelled)) {
+			return false;
+		}
+	}
+	copyPrefix(treeGeom, 2 * treeBranchCount(iteration), cpuGeom);
+	return true;
+}
+
+
+void FractalRefiner::clear() {
+	// Swapped for empty ones, clearing alone would keep the capacity
+	sierpinskiLevels = {};
+	levyLevels = {};
+	levyColours = {};
+	treeGeom = {};
+	treeTips = {};
+	treeDepth = -1;
+	residentScene = -1;
+}
+
+
+/*
+* Adds the next Sierpinski Triangle level, built from the deepest resident one.
+*
+* The colour change of a triangle at each step of its path is
+* direction * (remaining iterations / total iterations) * 0.33. Going from a total of N to
+* N + 1 iterations adds 1 to the remaining iterations of every step already taken and adds a
+* final step with 1 remaining, so the sums of both kept per triangle update exactly in integers.
+*/
+bool FractalRefiner::refineSierpinski(const std::atomic<bool>* cancelled) {
+	SierpinskiTriangle root = sierpinskiRoot();
+
+	SierpinskiLevel next;
+	if (sierpinskiLevels.empty()) {
+		next.cpuGeom.verts = { root.A, root.B, root.C };
+		next.cpuGeom.cols = { root.colour, root.colour, root.colour };
+		next.colourSums = { glm::ivec4(0) };
+		sierpinskiLevels.push_back(std::move(next));
+		return true;
+	}
+
+	const SierpinskiLevel& previous = sierpinskiLevels.back();
+	int totalIterations = int(sierpinskiLevels.size());
+	std::size_t parents = previous.colourSums.size();
+
+	next.cpuGeom.verts.resize(9 * parents);
+	next.cpuGeom.cols.resize(9 * parents);
+	next.colourSums.resize(3 * parents);
+
+	// Colour direction of the top, left and right children (green, blue)
+	const glm::ivec2 directions[3] = { { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+	for (std::size_t k = 0; k < parents; k++) {
+		if (isCancelled(cancelled)) {
+			return false;
+		}
+
+		const glm::vec3* corners = &previous.cpuGeom.verts[3 * k];
+		SierpinskiTriangle parent(corners[0], corners[1], corners[2], root.colour);
+		std::array<SierpinskiTriangle, 3> children = parent.subdivide(1, 1); // Only the positions are used
+		glm::ivec4 sums = previous.colourSums[k];
+
+		for (std::size_t c = 0; c < 3; c++) {
+			std::size_t child = 3 * k + c;
+			glm::ivec2 direction = directions[c];
+			glm::ivec4 childSums(
+				sums.x + sums.z + direction.x,
+				sums.y + sums.w + direction.y,
+				sums.z + direction.x,
+				sums.w + direction.y
+			);
+			next.colourSums[child] = childSums;
+
+			glm::vec3 colour(
+				root.colour.x,
+				root.colour.y + (static_cast<float>(childSums.x) / totalIterations) * 0.33f,
+				root.colour.z + (static_cast<float>(childSums.y) / totalIterations) * 0.33f
+			);
+
+			glm::vec3* verts = &next.cpuGeom.verts[3 * child];
+			glm::vec3* cols = &next.cpuGeom.cols[3 * child];
+			verts[0] = children[c].A; // Lower Left
+			verts[1] = children[c].B; // Lower Right
+			verts[2] = children[c].C; // Upper
+			cols[0] = colour;
+			cols[1] = colour;
+			cols[2] = colour;
+		}
+	}
+
+	sierpinskiLevels.push_back(std::move(next));
+	return true;
+}
+
+
+/*
+* Adds the next Levy C Curve level, built from the deepest resident one.
+*
+* Every point of level n is kept and a new corner is inserted between each pair of neighbours.
+* The colours depend on the total number of iterations, so they are mixed again from the two
+* ends of the curve down, in the same order and with the same arithmetic as the recursion
+*/
+bool FractalRefiner::refineLevy(const std::atomic<bool>* cancelled) {
+	LevyCCurve root = levyRoot();
+
+	LevyLevel next;
+	if (levyLevels.empty()) {
+		next.points = { root.A, root.B };
+	}
+	else {
+		const std::vector<glm::vec3>& previous = levyLevels.back().points;
+		std::size_t segments = previous.size() - 1;
+		next.points.resize(2 * segments + 1);
+
+		for (std::size_t k = 0; k < segments; k++) {
+			if (isCancelled(cancelled)) {
+				return false;
+			}
+			LevyCCurve parent(previous[k], previous[k + 1], root.colourA, root.colourB);
+			next.points[2 * k] = previous[k];
+			next.points[2 * k + 1] = parent.subdivide(1, 2)[0].B; // Only the new corner is used
+		}
+		next.points[2 * segments] = previous[segments];
+	}
+
+	// Colour every point, shallowest corners first
+	int iteration = int(levyLevels.size());
+	int totalIterations = iteration * 2; // Number of iterations in one curve
+	std::size_t segments = next.points.size() - 1;
+
+	levyColours.resize(next.points.size());
+	levyColours.front() = root.colourA;
+	levyColours.back() = root.colourB;
+	for (int depth = 0; depth < iteration; depth++) {
+		if (isCancelled(cancelled)) {
+			return false;
+		}
+		int remaining = iteration - depth;
+		float colourMidpoint = (static_cast<float>(totalIterations) - remaining) / totalIterations;
+
+		std::size_t step = segments >> depth;
+		for (std::size_t a = 0; a < segments; a += step) {
+			levyColours[a + step / 2] = glm::mix(levyColours[a], levyColours[a + step], colourMidpoint);
+		}
+	}
+
+	// Split the path back into separate lines
+	next.cpuGeom.verts.resize(2 * segments);
+	next.cpuGeom.cols.resize(2 * segments);
+	for (std::size_t k = 0; k < segments; k++) {
+		next.cpuGeom.verts[2 * k] = next.points[k]; // Left point
+		next.cpuGeom.verts[2 * k + 1] = next.points[k + 1]; // Right point
+		next.cpuGeom.cols[2 * k] = levyColours[k];
+		next.cpuGeom.cols[2 * k + 1] = levyColours[k + 1];
+	}
+
+	levyLevels.push_back(std::move(next));
+	return true;
+}
+
+
+/*
+* Adds the next tree level by growing three branches on every tip of the deepest resident level.
+* The new branches are appended, so every iteration is a prefix of the resident geometry
+*/
+bool FractalRefiner::refineTree(const std::atomic<bool>* cancelled) {
+	if (treeDepth < 0) {
+		Tree trunk = treeRoot();
+		treeGeom.verts = { trunk.base, trunk.top };
+		treeGeom.cols = { trunk.colour, trunk.colour };
+		treeTips = { trunk };
+		treeDepth = 0;
+		return true;
+	}
+
+	std::size_t previousSize = treeGeom.verts.size();
+	std::vector<Tree> nextTips;
+	nextTips.reserve(3 * treeTips.size());
+
+	for (const Tree& tip : treeTips) {
+		if (isCancelled(cancelled)) {
+			// Drop the partial level
+			treeGeom.verts.resize(previousSize);
+			treeGeom.cols.resize(previousSize);
+			return false;
+		}
+
+		for (const Tree& branch : tip.grow(treeDepth + 1)) {
+			treeGeom.verts.push_back(branch.base); // Left point
+			treeGeom.verts.push_back(branch.top); // Right point
+			treeGeom.cols.push_back(branch.colour);
+			treeGeom.cols.push_back(branch.colour);
+			nextTips.push_back(branch);
+		}
+	}
+
+	treeTips = std::move(nextTips);
+	treeDepth++;
+	return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a generator that keeps the levels it has built resident,
+// so changing the iteration by one only costs the work of the new level.
+//
+// Every level n primitive maps to a fixed set of level n + 1 primitives
+// (3 triangles, 2 lines, or 3 new branches on each tip of the tree), so level
+// n + 1 is refined straight from the resident level n buffer instead of
+// recursing again from the root. Stepping down reuses the coarser level, which
+// is still resident.
+//
+// The Levy C Curve is the same, byte for byte, as the recursive generator.
+// Only the scene last generated is kept, so the levels of the deepest Levy C
+// Curve (about a million vertices) do not stay around after switching scenes.
+//
+// Sierpinski Triangle colours depend on the total number of iterations, so they
+// are rebuilt from exact per-triangle integer sums and may differ from the
+// recursive generator in the last bits. The tree is stored one level after
+// another (each iteration is a prefix of the next) rather than children first.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+
+class FractalRefiner {
+
+public:
+	FractalRefiner() = default;
+
+	// Brings the resident levels of the requested scene up to the requested iteration
+	// and copies that iteration into cpuGeom, freeing the levels of any other scene first.
+	// Returns false if cancelled, in which case the levels built so far stay resident
+	bool generate(const FractalRequest& request, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
+
+	// Frees every resident level
+	void clear();
+
+	// The part of generate for each scene, which the Scene table points to. They assume the
+	// levels resident are those of their scene
+	bool generateSierpinski(int iteration, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled);
+	bool generateLevy(int iteration, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled);
+	bool generateTree(int iteration, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled);
+
+private:
+	struct SierpinskiLevel {
+		CPU_Geometry cpuGeom;
+		// Per triangle, the sum over its path of (direction * remaining iterations) and of
+		// direction, for the green and blue channels: (sum g, sum b, direction g, direction b)
+		std::vector<glm::ivec4> colourSums;
+	};
+
+	struct LevyLevel {
+		std::vector<glm::vec3> points; // The curve as one connected path
+		CPU_Geometry cpuGeom;
+	};
+
+	std::vector<SierpinskiLevel> sierpinskiLevels;
+	std::vector<LevyLevel> levyLevels;
+	std::vector<glm::vec3> levyColours; // Scratch for recolouring a Levy level
+
+	CPU_Geometry treeGeom; // Every resident level, one after another
+	std::vector<Tree> treeTips; // Branches of the deepest resident level
+	int treeDepth = -1;
+
+	int residentScene = -1; // Whose levels are kept, -1 for none
+
+	bool refineSierpinski(const std::atomic<bool>* cancelled);
+	bool refineLevy(const std::atomic<bool>* cancelled);
+	bool refineTree(const std::atomic<bool>* cancelled);
+};
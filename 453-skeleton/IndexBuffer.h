@@ -0,0 +1,23 @@
+#pragma once
+
+#include "GLHandles.h"
+
+#include <glad/glad.h>
+
+
+// Element array buffer. It is bound to whichever VAO is bound when it is created or
+// uploaded to, so create it after the VAO it belongs to
+class IndexBuffer {
+
+public:
+	IndexBuffer();
+
+	// Rule of zero, the IndexBufferHandle does the RAII for us (see VertexBuffer.h)
+
+	// Public interface
+	void bind() const { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferID); }
+	void uploadData(GLsizeiptr size, const void* data, GLenum usage);
+
+private:
+	IndexBufferHandle bufferID;
+};
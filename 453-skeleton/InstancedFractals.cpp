@@ -0,0 +1,50 @@
+#include "InstancedFractals.h"
+
+#include <cmath>
+#include <stdexcept>
+
+
+namespace {
+
+	/*
+	* Adds one instance per leaf triangle of triangle to instances
+	*
+	* @param triangle	Triangle from previous iteration
+	* @param iteration	Number of iterations left to generate
+	* @param totalIterations	Number of iterations to be generated in total
+	* @param shapeA	First vertex of the leaf shape, the offset moves it onto the leaf's first vertex
+	* @param instances	Output instances
+	* @param cancelled	Optional flag, generation stops early once it is set
+	*
+	*/
+	void addInstances(const SierpinskiTriangle& triangle, int iteration, int totalIterations, const glm::vec3& shapeA, std::vector<TriangleInstance>& instances, const std::atomic<bool>* cancelled) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		if (iteration > 0) {
+			for (const SierpinskiTriangle& child : triangle.subdivide(iteration, totalIterations)) {
+				addInstances(child, iteration - 1, totalIterations, shapeA, instances, cancelled);
+			}
+		}
+		else {
+			instances.push_back(makeTriangleInstance(triangle.A - shapeA, triangle.colour));
+		}
+	}
+}
+
+
+void sierpinskiTriangleCreateInstanced(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	if (iteration > MAX_FRACTAL_DEPTH) {
+		throw std::runtime_error("Too many iterations for the instanced generator.");
+	}
+
+	// Every leaf is the initial triangle scaled by 2^-iteration, in the same vertex order
+	float scale = std::ldexp(1.f, -iteration);
+	cpuGeom.verts.assign({ triangle.A * scale, triangle.B * scale, triangle.C * scale });
+	cpuGeom.cols.clear();
+
+	cpuGeom.instances.clear();
+	cpuGeom.instances.reserve(sierpinskiTriangleCount(iteration));
+	addInstances(triangle, iteration, totalIterations, cpuGeom.verts[0], cpuGeom.instances, cancelled);
+}
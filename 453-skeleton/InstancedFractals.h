@@ -0,0 +1,22 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a generator that writes the Sierpinski Triangle as
+// instances of a single triangle.
+//
+// Subdividing a triangle gives three copies of it at half the size, each
+// translated to one of its corners. So every leaf triangle at iteration n is
+// the initial triangle scaled by 2^-n plus an offset, and only the offset and
+// colour of each leaf need to be generated (see TriangleInstance).
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+#include <atomic>
+
+
+// Replace the contents of cpuGeom with the leaf shape (the triangle scaled by 2^-iteration) in
+// verts and one instance per leaf, in the order the recursive generator emits them.
+// Throws std::runtime_error if iteration is above MAX_FRACTAL_DEPTH
+void sierpinskiTriangleCreateInstanced(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
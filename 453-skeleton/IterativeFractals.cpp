@@ -0,0 +1,363 @@
+#include "IterativeFractals.h"
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+
+namespace {
+
+	// Where the generators write their vertices. Both reserve exactly vertexCount
+	// up front, then take one position and colour at a time
+
+	struct SeparateSink {
+		CPU_Geometry& cpuGeom;
+
+		void prepare(std::size_t vertexCount) {
+			cpuGeom.verts.clear();
+			cpuGeom.cols.clear();
+			cpuGeom.verts.reserve(vertexCount);
+			cpuGeom.cols.reserve(vertexCount);
+		}
+		void add(const glm::vec3& position, const glm::vec3& colour) {
+			cpuGeom.verts.push_back(position);
+			cpuGeom.cols.push_back(colour);
+		}
+	};
+
+	struct InterleavedSink {
+		std::vector<Vertex>& vertices;
+
+		void prepare(std::size_t vertexCount) {
+			vertices.clear();
+			vertices.reserve(vertexCount);
+		}
+		void add(const glm::vec3& position, const glm::vec3& colour) {
+			vertices.push_back({ position, colour });
+		}
+	};
+
+	struct PackedSink {
+		std::vector<PackedVertex>& packedVertices;
+
+		void prepare(std::size_t vertexCount) {
+			packedVertices.clear();
+			packedVertices.reserve(vertexCount);
+		}
+		void add(const glm::vec3& position, const glm::vec3& colour) {
+			packedVertices.push_back(packVertex(position, colour));
+		}
+	};
+
+	// The same, for memory that already has room for every vertex
+
+	struct SeparatePointerSink {
+		glm::vec3* verts;
+		glm::vec3* cols;
+
+		void prepare(std::size_t) {}
+		void add(const glm::vec3& position, const glm::vec3& colour) {
+			*verts++ = position;
+			*cols++ = colour;
+		}
+	};
+
+	struct InterleavedPointerSink {
+		Vertex* vertices;
+
+		void prepare(std::size_t) {}
+		void add(const glm::vec3& position, const glm::vec3& colour) {
+			*vertices++ = { position, colour };
+		}
+	};
+
+	struct PackedPointerSink {
+		PackedVertex* packedVertices;
+
+		void prepare(std::size_t) {}
+		void add(const glm::vec3& position, const glm::vec3& colour) {
+			*packedVertices++ = packVertex(position, colour);
+		}
+	};
+
+	// Hands interleaved vertices over one full chunk at a time. Whatever is left at the end
+	// is handed over by flush()
+	struct ChunkSink {
+		const VertexChunks& chunks;
+		std::vector<Vertex> chunk;
+
+		void prepare(std::size_t) {
+			chunk.reserve(chunks.chunkSize);
+		}
+		void add(const glm::vec3& position, const glm::vec3& colour) {
+			chunk.push_back({ position, colour });
+			if (chunk.size() == chunks.chunkSize) {
+				chunks.emit(chunk);
+				chunk.clear(); // Whatever emit left behind
+				chunk.reserve(chunks.chunkSize);
+			}
+		}
+		void flush() {
+			if (!chunk.empty()) {
+				chunks.emit(chunk);
+			}
+		}
+	};
+
+	// Calls generate with the pointer sink matching the layout of destination
+	template <typename Generate>
+	void withPointerSink(const VertexDestination& destination, Generate generate) {
+		if (destination.layout == VertexLayout::Interleaved) {
+			generate(InterleavedPointerSink{ static_cast<Vertex*>(destination.vertices) });
+		}
+		else if (destination.layout == VertexLayout::Packed) {
+			generate(PackedPointerSink{ static_cast<PackedVertex*>(destination.vertices) });
+		}
+		else {
+			generate(SeparatePointerSink{ static_cast<glm::vec3*>(destination.vertices), destination.colours });
+		}
+	}
+
+
+	// Fixed capacity stack, lives entirely in the generator's stack frame
+	template <typename T, std::size_t Capacity>
+	class FixedStack {
+	public:
+		bool empty() const { return size == 0; }
+		void push(const T& item) { items[size++] = item; }
+		T pop() { return items[--size]; }
+		T& top() { return items[size - 1]; }
+
+	private:
+		std::array<T, Capacity> items;
+		std::size_t size = 0;
+	};
+
+
+	struct SierpinskiFrame {
+		SierpinskiTriangle triangle;
+		int iteration;
+	};
+
+	struct LevyFrame {
+		LevyCCurve line;
+		int iteration;
+	};
+
+	// The tree emits each branch after its children, so a frame stays on the stack
+	// until all three of its children have been generated
+	struct TreeFrame {
+		Tree branch;
+		int iteration;
+		int iterationCounter;
+		std::array<Tree, 3> children;
+		int nextChild;
+	};
+}
+
+
+/*
+* Creates vertices and colours for Sierpinski Triangle without recursion
+*
+* @param triangle	Initial triangle
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param out	One of the sinks above, to write the vertices to
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+template <typename Sink>
+void sierpinskiTriangleCreateIterativeInto(const SierpinskiTriangle& triangle, int iteration, int totalIterations, Sink&& out, const std::atomic<bool>* cancelled) {
+	checkFractalDepth(iteration);
+	out.prepare(3 * sierpinskiTriangleCount(iteration));
+
+	// Each level leaves at most two pending siblings behind
+	FixedStack<SierpinskiFrame, 2 * MAX_FRACTAL_DEPTH + 1> stack;
+	stack.push({ triangle, iteration });
+
+	while (!stack.empty()) {
+		SierpinskiFrame frame = stack.pop();
+
+		if (frame.iteration > 0) {
+			if (isCancelled(cancelled)) {
+				return;
+			}
+			// Push in reverse so the children come off the stack in generation order
+			std::array<SierpinskiTriangle, 3> children = frame.triangle.subdivide(frame.iteration, totalIterations);
+			for (int i = 2; i >= 0; i--) {
+				stack.push({ children[i], frame.iteration - 1 });
+			}
+		}
+		else {
+			// Add vertices and colours to the output
+			out.add(frame.triangle.A, frame.triangle.colour); // Lower Left
+			out.add(frame.triangle.B, frame.triangle.colour); // Lower Right
+			out.add(frame.triangle.C, frame.triangle.colour); // Upper
+		}
+	}
+}
+
+
+/*
+* Creates vertices and colours for Levy C Curve without recursion
+*
+* @param line	Initial line
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param out	One of the sinks above, to write the vertices to
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+template <typename Sink>
+void levyCCurveCreateIterativeInto(const LevyCCurve& line, int iteration, int totalIterations, Sink&& out, const std::atomic<bool>* cancelled) {
+	checkFractalDepth(iteration);
+	out.prepare(2 * levySegmentCount(iteration));
+
+	// Each level leaves at most one pending sibling behind
+	FixedStack<LevyFrame, MAX_FRACTAL_DEPTH + 1> stack;
+	stack.push({ line, iteration });
+
+	while (!stack.empty()) {
+		LevyFrame frame = stack.pop();
+
+		if (frame.iteration > 0) {
+			if (isCancelled(cancelled)) {
+				return;
+			}
+			std::array<LevyCCurve, 2> children = frame.line.subdivide(frame.iteration, totalIterations);
+			stack.push({ children[1], frame.iteration - 1 });
+			stack.push({ children[0], frame.iteration - 1 });
+		}
+		else {
+			// Add vertices and colours to the output
+			out.add(frame.line.A, frame.line.colourA); // Left point
+			out.add(frame.line.B, frame.line.colourB); // Right point
+		}
+	}
+}
+
+
+/*
+* Creates vertices and colours for Tree scene without recursion
+*
+* @param branch		Tree trunk
+* @param iteration	Number of iterations to generate
+* @param iterationCounter	tracks number of iterations completed to detect when to start creating leaves
+* @param out	One of the sinks above, to write the vertices to
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+template <typename Sink>
+void treeCreateIterativeInto(const Tree& branch, int iteration, int iterationCounter, Sink&& out, const std::atomic<bool>* cancelled) {
+	checkFractalDepth(iteration);
+	out.prepare(2 * treeBranchCount(iteration));
+
+	FixedStack<TreeFrame, MAX_FRACTAL_DEPTH + 1> stack;
+	stack.push({ branch, iteration, iterationCounter, {}, 0 });
+	if (iteration > 0) {
+		stack.top().children = branch.grow(iterationCounter + 1);
+	}
+
+	while (!stack.empty()) {
+		TreeFrame& frame = stack.top();
+
+		// Generate the next child first, if there is one left
+		if (frame.iteration > 0 && frame.nextChild < 3) {
+			if (isCancelled(cancelled)) {
+				return;
+			}
+			const Tree& child = frame.children[frame.nextChild++];
+			int childIteration = frame.iteration - 1;
+			int childCounter = frame.iterationCounter + 1;
+
+			stack.push({ child, childIteration, childCounter, {}, 0 });
+			if (childIteration > 0) {
+				stack.top().children = child.grow(childCounter + 1);
+			}
+			continue;
+		}
+
+		// Add vertices and colours to the output
+		out.add(frame.branch.base, frame.branch.colour); // Left point
+		out.add(frame.branch.top, frame.branch.colour); // Right point
+
+		stack.pop();
+	}
+}
+
+
+void sierpinskiTriangleCreateIterative(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	sierpinskiTriangleCreateIterativeInto(triangle, iteration, totalIterations, SeparateSink{ cpuGeom }, cancelled);
+}
+
+void levyCCurveCreateIterative(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	levyCCurveCreateIterativeInto(line, iteration, totalIterations, SeparateSink{ cpuGeom }, cancelled);
+}
+
+void treeCreateIterative(const Tree& branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	treeCreateIterativeInto(branch, iteration, iterationCounter, SeparateSink{ cpuGeom }, cancelled);
+}
+
+
+void sierpinskiTriangleCreateIterative(const SierpinskiTriangle& triangle, int iteration, int totalIterations, std::vector<Vertex>& vertices, const std::atomic<bool>* cancelled) {
+	sierpinskiTriangleCreateIterativeInto(triangle, iteration, totalIterations, InterleavedSink{ vertices }, cancelled);
+}
+
+void levyCCurveCreateIterative(const LevyCCurve& line, int iteration, int totalIterations, std::vector<Vertex>& vertices, const std::atomic<bool>* cancelled) {
+	levyCCurveCreateIterativeInto(line, iteration, totalIterations, InterleavedSink{ vertices }, cancelled);
+}
+
+void treeCreateIterative(const Tree& branch, int iteration, int iterationCounter, std::vector<Vertex>& vertices, const std::atomic<bool>* cancelled) {
+	treeCreateIterativeInto(branch, iteration, iterationCounter, InterleavedSink{ vertices }, cancelled);
+}
+
+
+void sierpinskiTriangleCreateIterative(const SierpinskiTriangle& triangle, int iteration, int totalIterations, std::vector<PackedVertex>& packedVertices, const std::atomic<bool>* cancelled) {
+	sierpinskiTriangleCreateIterativeInto(triangle, iteration, totalIterations, PackedSink{ packedVertices }, cancelled);
+}
+
+void levyCCurveCreateIterative(const LevyCCurve& line, int iteration, int totalIterations, std::vector<PackedVertex>& packedVertices, const std::atomic<bool>* cancelled) {
+	levyCCurveCreateIterativeInto(line, iteration, totalIterations, PackedSink{ packedVertices }, cancelled);
+}
+
+void treeCreateIterative(const Tree& branch, int iteration, int iterationCounter, std::vector<PackedVertex>& packedVertices, const std::atomic<bool>* cancelled) {
+	treeCreateIterativeInto(branch, iteration, iterationCounter, PackedSink{ packedVertices }, cancelled);
+}
+
+
+void sierpinskiTriangleCreateIterative(const SierpinskiTriangle& triangle, int iteration, int totalIterations, const VertexDestination& destination, const std::atomic<bool>* cancelled) {
+	withPointerSink(destination, [&](auto&& out) { sierpinskiTriangleCreateIterativeInto(triangle, iteration, totalIterations, out, cancelled); });
+}
+
+void levyCCurveCreateIterative(const LevyCCurve& line, int iteration, int totalIterations, const VertexDestination& destination, const std::atomic<bool>* cancelled) {
+	withPointerSink(destination, [&](auto&& out) { levyCCurveCreateIterativeInto(line, iteration, totalIterations, out, cancelled); });
+}
+
+void treeCreateIterative(const Tree& branch, int iteration, int iterationCounter, const VertexDestination& destination, const std::atomic<bool>* cancelled) {
+	withPointerSink(destination, [&](auto&& out) { treeCreateIterativeInto(branch, iteration, iterationCounter, out, cancelled); });
+}
+
+
+void sierpinskiTriangleCreateIterative(const SierpinskiTriangle& triangle, int iteration, int totalIterations, const VertexChunks& chunks, const std::atomic<bool>* cancelled) {
+	ChunkSink sink{ chunks, {} };
+	sierpinskiTriangleCreateIterativeInto(triangle, iteration, totalIterations, sink, cancelled);
+	if (!isCancelled(cancelled)) {
+		sink.flush();
+	}
+}
+
+void levyCCurveCreateIterative(const LevyCCurve& line, int iteration, int totalIterations, const VertexChunks& chunks, const std::atomic<bool>* cancelled) {
+	ChunkSink sink{ chunks, {} };
+	levyCCurveCreateIterativeInto(line, iteration, totalIterations, sink, cancelled);
+	if (!isCancelled(cancelled)) {
+		sink.flush();
+	}
+}
+
+void treeCreateIterative(const Tree& branch, int iteration, int iterationCounter, const VertexChunks& chunks, const std::atomic<bool>* cancelled) {
+	ChunkSink sink{ chunks, {} };
+	treeCreateIterativeInto(branch, iteration, iterationCounter, sink, cancelled);
+	if (!isCancelled(cancelled)) {
+		sink.flush();
+	}
+}
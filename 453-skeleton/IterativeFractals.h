@@ -0,0 +1,47 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains versions of the fractal generators that do not recurse on
+// the call stack and do not allocate.
+//
+// Each one walks the recursion with an explicit, fixed size stack (the depth is
+// bounded by MAX_FRACTAL_DEPTH) and reserves exactly the number of vertices the
+// closed form primitive counts call for up front. When cpuGeom is reused between
+// calls (like the slots of GenerationWorker) it keeps its capacity, so
+// regenerating at a size that has been reached before does no heap allocation.
+//
+// The output is the same, byte for byte, as the recursive generators.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+#include <atomic>
+#include <vector>
+
+
+// Replace the contents of cpuGeom. Throw std::runtime_error if iteration is above MAX_FRACTAL_DEPTH
+void sierpinskiTriangleCreateIterative(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
+void levyCCurveCreateIterative(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
+void treeCreateIterative(const Tree& branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
+
+// Same, but write interleaved positions and colours straight into vertices (VertexLayout::Interleaved)
+void sierpinskiTriangleCreateIterative(const SierpinskiTriangle& triangle, int iteration, int totalIterations, std::vector<Vertex>& vertices, const std::atomic<bool>* cancelled = nullptr);
+void levyCCurveCreateIterative(const LevyCCurve& line, int iteration, int totalIterations, std::vector<Vertex>& vertices, const std::atomic<bool>* cancelled = nullptr);
+void treeCreateIterative(const Tree& branch, int iteration, int iterationCounter, std::vector<Vertex>& vertices, const std::atomic<bool>* cancelled = nullptr);
+
+// Same, but write packed vertices (VertexLayout::Packed)
+void sierpinskiTriangleCreateIterative(const SierpinskiTriangle& triangle, int iteration, int totalIterations, std::vector<PackedVertex>& packedVertices, const std::atomic<bool>* cancelled = nullptr);
+void levyCCurveCreateIterative(const LevyCCurve& line, int iteration, int totalIterations, std::vector<PackedVertex>& packedVertices, const std::atomic<bool>* cancelled = nullptr);
+void treeCreateIterative(const Tree& branch, int iteration, int iterationCounter, std::vector<PackedVertex>& packedVertices, const std::atomic<bool>* cancelled = nullptr);
+
+// Same, but write straight into destination (a mapped buffer, for example), which needs room for
+// the closed form number of vertices (fractalVertexCount)
+void sierpinskiTriangleCreateIterative(const SierpinskiTriangle& triangle, int iteration, int totalIterations, const VertexDestination& destination, const std::atomic<bool>* cancelled = nullptr);
+void levyCCurveCreateIterative(const LevyCCurve& line, int iteration, int totalIterations, const VertexDestination& destination, const std::atomic<bool>* cancelled = nullptr);
+void treeCreateIterative(const Tree& branch, int iteration, int iterationCounter, const VertexDestination& destination, const std::atomic<bool>* cancelled = nullptr);
+
+// Same, but hand interleaved vertices to chunks one full chunk at a time, as they are generated
+void sierpinskiTriangleCreateIterative(const SierpinskiTriangle& triangle, int iteration, int totalIterations, const VertexChunks& chunks, const std::atomic<bool>* cancelled = nullptr);
+void levyCCurveCreateIterative(const LevyCCurve& line, int iteration, int totalIterations, const VertexChunks& chunks, const std::atomic<bool>* cancelled = nullptr);
+void treeCreateIterative(const Tree& branch, int iteration, int iterationCounter, const VertexChunks& chunks, const std::atomic<bool>* cancelled = nullptr);
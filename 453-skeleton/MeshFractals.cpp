@@ -0,0 +1,111 @@
+#include "MeshFractals.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+
+namespace {
+
+	// Bits of x and y (the figure lies in the z = 0 plane). Adding 0 turns -0 into 0
+	std::uint64_t positionKey(const glm::vec3& position) {
+		float x = position.x + 0.f;
+		float y = position.y + 0.f;
+		std::uint32_t xBits;
+		std::uint32_t yBits;
+		std::memcpy(&xBits, &x, sizeof(x));
+		std::memcpy(&yBits, &y, sizeof(y));
+		return (std::uint64_t(xBits) << 32) | yBits;
+	}
+
+	template <typename Index>
+	struct MeshBuilder {
+		std::vector<Vertex>& vertices;
+		std::vector<Index>& indices;
+		std::unordered_map<std::uint64_t, GLuint>& lookup;
+
+		// Number of the vertex at position, adding it if it is new
+		GLuint vertexAt(const glm::vec3& position, const glm::vec3& colour) {
+			auto inserted = lookup.emplace(positionKey(position), GLuint(vertices.size()));
+			if (inserted.second) {
+				vertices.push_back({ position, colour });
+			}
+			return inserted.first->second;
+		}
+
+		void addTriangle(const SierpinskiTriangle& triangle) {
+			GLuint b = vertexAt(triangle.B, triangle.colour);
+			GLuint c = vertexAt(triangle.C, triangle.colour);
+			GLuint a = vertexAt(triangle.A, triangle.colour);
+			vertices[a].colour = triangle.colour; // A belongs to this triangle only
+
+			// Same winding as A, B, C with A last, so it is the provoking vertex
+			indices.push_back(Index(b));
+			indices.push_back(Index(c));
+			indices.push_back(Index(a));
+		}
+
+		void create(const SierpinskiTriangle& triangle, int iteration, int totalIterations, const std::atomic<bool>* cancelled) {
+			if (isCancelled(cancelled)) {
+				return;
+			}
+
+			if (iteration > 0) {
+				for (const SierpinskiTriangle& child : triangle.subdivide(iteration, totalIterations)) {
+					create(child, iteration - 1, totalIterations, cancelled);
+				}
+			}
+			else {
+				addTriangle(triangle);
+			}
+		}
+	};
+
+	template <typename Index>
+	void createMesh(const SierpinskiTriangle& triangle, int iteration, int totalIterations, std::vector<Vertex>& vertices, std::vector<Index>& indices, std::unordered_map<std::uint64_t, GLuint>& lookup, const std::atomic<bool>* cancelled) {
+		indices.reserve(3 * sierpinskiTriangleCount(iteration));
+		MeshBuilder<Index>{ vertices, indices, lookup }.create(triangle, iteration, totalIterations, cancelled);
+	}
+}
+
+
+std::size_t sierpinskiMeshVertexCount(int iteration) {
+	return (sierpinskiTriangleCount(iteration + 1) + 3) / 2;
+}
+
+
+/*
+* Creates the shared vertices and triangles of the Sierpinski Triangle
+*
+* @param triangle	Initial triangle
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param cpuGeom	Collection of vectors for geometry
+* @param cancelled	Optional flag, generation stops early once it is set
+* @param arena	Optional scratch memory for the vertex lookup
+*
+*/
+void sierpinskiTriangleCreateMesh(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled, GenerationArena* arena) {
+	std::size_t vertexCount = sierpinskiMeshVertexCount(iteration);
+
+	std::unordered_map<std::uint64_t, GLuint> localLookup;
+	std::unordered_map<std::uint64_t, GLuint>& lookup = (arena != nullptr) ? arena->meshVertices : localLookup;
+	lookup.clear();
+	lookup.reserve(vertexCount);
+
+	cpuGeom.verts.clear();
+	cpuGeom.cols.clear();
+	cpuGeom.vertices.clear();
+	cpuGeom.vertices.reserve(vertexCount);
+	cpuGeom.indices.clear();
+	cpuGeom.shortIndices.clear();
+
+	if (vertexCount <= std::numeric_limits<GLushort>::max()) {
+		createMesh(triangle, iteration, totalIterations, cpuGeom.vertices, cpuGeom.shortIndices, lookup, cancelled);
+	}
+	else {
+		createMesh(triangle, iteration, totalIterations, cpuGeom.vertices, cpuGeom.indices, lookup, cancelled);
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a generator that writes the Sierpinski Triangle as an
+// indexed mesh.
+//
+// Neighbouring leaf triangles share their corners. Every corner is computed
+// once (as a midpoint) and copied unchanged into the triangles that share it,
+// so equal positions are bit for bit equal and are looked up by their bits.
+// Each vertex is then stored once, and the triangles become three indices.
+//
+// Neighbours have different colours, so the mesh is meant to be drawn with flat
+// shading. Every leaf is a translated copy of the same triangle, so no two
+// leaves share their first corner (A). Each triangle lists A last, which makes
+// it the provoking vertex, and A carries the colour of its triangle.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+#include <atomic>
+#include <cstddef>
+
+
+// Number of distinct corners of the leaf triangles, (3^(n + 1) + 3) / 2
+std::size_t sierpinskiMeshVertexCount(int iteration);
+
+// Replace the contents of cpuGeom with the shared vertices (in vertices) and the triangles
+// (in shortIndices when they fit, otherwise in indices), in the order the recursive generator
+// emits them. The vertex lookup comes from arena when given
+void sierpinskiTriangleCreateMesh(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr, GenerationArena* arena = nullptr);
@@ -0,0 +1,188 @@
+#include "ParallelFractals.h"
+
+#include <cstddef>
+
+
+namespace {
+
+	// Subtrees smaller than this are generated inline rather than as their own task
+	constexpr std::size_t MIN_PRIMITIVES_PER_TASK = 4096;
+
+	// Start of the pre-sized vertex and colour arrays
+	struct VertexSlice {
+		glm::vec3* verts;
+		glm::vec3* cols;
+	};
+
+	void resize(CPU_Geometry& cpuGeom, std::size_t vertexCount) {
+		cpuGeom.verts.resize(vertexCount);
+		cpuGeom.cols.resize(vertexCount);
+	}
+
+
+	// Each function below generates one subtree whose first primitive is written at index first.
+	// Children are laid out one after another exactly like the serial recursion emits them.
+
+	void sierpinskiSubtree(TaskGroup& group, const SierpinskiTriangle& triangle, int iteration, int totalIterations, VertexSlice out, std::size_t first, const std::atomic<bool>* cancelled) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		if (iteration > 0) {
+			std::size_t childCount = sierpinskiTriangleCount(iteration - 1);
+			std::array<SierpinskiTriangle, 3> children = triangle.subdivide(iteration, totalIterations);
+
+			for (std::size_t i = 0; i < children.size(); i++) {
+				std::size_t childFirst = first + i * childCount;
+				if (childCount >= MIN_PRIMITIVES_PER_TASK) {
+					SierpinskiTriangle child = children[i];
+					group.run([&group, child, iteration, totalIterations, out, childFirst, cancelled]() {
+						sierpinskiSubtree(group, child, iteration - 1, totalIterations, out, childFirst, cancelled);
+					});
+				}
+				else {
+					sierpinskiSubtree(group, children[i], iteration - 1, totalIterations, out, childFirst, cancelled);
+				}
+			}
+		}
+		else {
+			std::size_t v = 3 * first;
+			out.verts[v] = triangle.A; // Lower Left
+			out.verts[v + 1] = triangle.B; // Lower Right
+			out.verts[v + 2] = triangle.C; // Upper
+
+			out.cols[v] = triangle.colour;
+			out.cols[v + 1] = triangle.colour;
+			out.cols[v + 2] = triangle.colour;
+		}
+	}
+
+
+	void levySubtree(TaskGroup& group, const LevyCCurve& line, int iteration, int totalIterations, VertexSlice out, std::size_t first, const std::atomic<bool>* cancelled) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		if (iteration > 0) {
+			std::size_t childCount = levySegmentCount(iteration - 1);
+			std::array<LevyCCurve, 2> children = line.subdivide(iteration, totalIterations);
+
+			for (std::size_t i = 0; i < children.size(); i++) {
+				std::size_t childFirst = first + i * childCount;
+				if (childCount >= MIN_PRIMITIVES_PER_TASK) {
+					LevyCCurve child = children[i];
+					group.run([&group, child, iteration, totalIterations, out, childFirst, cancelled]() {
+						levySubtree(group, child, iteration - 1, totalIterations, out, childFirst, cancelled);
+					});
+				}
+				else {
+					levySubtree(group, children[i], iteration - 1, totalIterations, out, childFirst, cancelled);
+				}
+			}
+		}
+		else {
+			std::size_t v = 2 * first;
+			out.verts[v] = line.A; // Left point
+			out.verts[v + 1] = line.B; // Right point
+
+			out.cols[v] = line.colourA;
+			out.cols[v + 1] = line.colourB;
+		}
+	}
+
+
+	void treeSubtree(TaskGroup& group, const Tree& branch, int iteration, int iterationCounter, VertexSlice out, std::size_t first, const std::atomic<bool>* cancelled) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		// Children come first, the branch itself is emitted after all of them
+		std::size_t self = first;
+		if (iteration > 0) {
+			iterationCounter++;
+			std::size_t childCount = treeBranchCount(iteration - 1);
+			std::array<Tree, 3> children = branch.grow(iterationCounter);
+
+			for (std::size_t i = 0; i < children.size(); i++) {
+				std::size_t childFirst = first + i * childCount;
+				if (childCount >= MIN_PRIMITIVES_PER_TASK) {
+					Tree child = children[i];
+					group.run([&group, child, iteration, iterationCounter, out, childFirst, cancelled]() {
+						treeSubtree(group, child, iteration - 1, iterationCounter, out, childFirst, cancelled);
+					});
+				}
+				else {
+					treeSubtree(group, children[i], iteration - 1, iterationCounter, out, childFirst, cancelled);
+				}
+			}
+			self += children.size() * childCount;
+		}
+
+		std::size_t v = 2 * self;
+		out.verts[v] = branch.base; // Left point
+		out.verts[v + 1] = branch.top; // Right point
+
+		out.cols[v] = branch.colour;
+		out.cols[v + 1] = branch.colour;
+	}
+}
+
+
+/*
+* Multithreaded sierpinskiTriangleCreate. Replaces the contents of cpuGeom
+*
+* @param triangle	Initial triangle
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param cpuGeom	Collection of vectors for geometry
+* @param pool	Threads to generate on
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+void sierpinskiTriangleCreateParallel(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, TaskPool& pool, const std::atomic<bool>* cancelled) {
+	resize(cpuGeom, 3 * sierpinskiTriangleCount(iteration));
+
+	TaskGroup group(pool);
+	sierpinskiSubtree(group, triangle, iteration, totalIterations, { cpuGeom.verts.data(), cpuGeom.cols.data() }, 0, cancelled);
+	group.wait();
+}
+
+
+/*
+* Multithreaded levyCCurveCreate. Replaces the contents of cpuGeom
+*
+* @param line	Initial line
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param cpuGeom	Collection of vectors for geometry
+* @param pool	Threads to generate on
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+void levyCCurveCreateParallel(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, TaskPool& pool, const std::atomic<bool>* cancelled) {
+	resize(cpuGeom, 2 * levySegmentCount(iteration));
+
+	TaskGroup group(pool);
+	levySubtree(group, line, iteration, totalIterations, { cpuGeom.verts.data(), cpuGeom.cols.data() }, 0, cancelled);
+	group.wait();
+}
+
+
+/*
+* Multithreaded treeCreate. Replaces the contents of cpuGeom
+*
+* @param branch		Tree trunk
+* @param iteration	Number of iterations to generate
+* @param iterationCounter	tracks number of iterations completed to detect when to start creating leaves
+* @param cpuGeom	Collection of vectors for geometry
+* @param pool	Threads to generate on
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+void treeCreateParallel(const Tree& branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom, TaskPool& pool, const std::atomic<bool>* cancelled) {
+	resize(cpuGeom, 2 * treeBranchCount(iteration));
+
+	TaskGroup group(pool);
+	treeSubtree(group, branch, iteration, iterationCounter, { cpuGeom.verts.data(), cpuGeom.cols.data() }, 0, cancelled);
+	group.wait();
+}
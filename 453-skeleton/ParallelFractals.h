@@ -0,0 +1,21 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains multithreaded versions of the fractal generators.
+//
+// The number of primitives below any node of the recursion is known in closed
+// form, so the output range of every subtree can be computed up front. Subtrees
+// are then generated concurrently into disjoint slices of a pre-sized
+// CPU_Geometry, which gives exactly the same bytes as the serial generators.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+#include "TaskPool.h"
+
+#include <atomic>
+
+
+void sierpinskiTriangleCreateParallel(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, TaskPool& pool, const std::atomic<bool>* cancelled = nullptr);
+void levyCCurveCreateParallel(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, TaskPool& pool, const std::atomic<bool>* cancelled = nullptr);
+void treeCreateParallel(const Tree& branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom, TaskPool& pool, const std::atomic<bool>* cancelled = nullptr);
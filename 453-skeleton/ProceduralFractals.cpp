@@ -0,0 +1,33 @@
+#include "ProceduralFractals.h"
+
+
+bool isProcedural(int sceneNumber) {
+	return fractalScene(sceneNumber).proceduralShader != nullptr;
+}
+
+
+GLsizei proceduralVertexCount(const FractalRequest& request) {
+	return GLsizei(fractalVertexCount(request));
+}
+
+
+void setProceduralUniforms(const FractalRequest& request, GLuint program) {
+	SubdivisionPrimitive root = fractalScene(request.sceneNumber).root();
+
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "scene"), request.sceneNumber);
+	glUniform1i(glGetUniformLocation(program, "iteration"), request.iteration);
+	glUniform2fv(glGetUniformLocation(program, "rootPositions"), 3, &root.points[0][0]);
+	glUniform3fv(glGetUniformLocation(program, "rootColours"), 2, &root.colours[0][0]);
+}
+
+
+void setPixelUniforms(int iteration, GLuint program) {
+	SierpinskiTriangle triangle = sierpinskiRoot();
+	glm::vec2 corners[3] = { glm::vec2(triangle.A), glm::vec2(triangle.B), glm::vec2(triangle.C) };
+
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "iteration"), iteration);
+	glUniform2fv(glGetUniformLocation(program, "corners"), 3, &corners[0][0]);
+	glUniform3fv(glGetUniformLocation(program, "baseColour"), 1, &triangle.colour[0]);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains the CPU side of the procedural renderer, which draws the
+// Sierpinski Triangle and Levy C Curve without generating anything.
+//
+// procedural.vert works out every vertex from gl_VertexID and the iteration,
+// so the whole figure is a glDrawArrays on an empty VAO (see
+// GPU_ProceduralGeometry). Changing the iteration only changes a uniform, and
+// memory use does not grow with the number of iterations.
+//
+// The Sierpinski Triangle can also be drawn per pixel: sierpinski.frag tests
+// every fragment of a full screen triangle (fullscreen.vert) against the
+// lattice of the requested level. Its cost only depends on the number of
+// pixels, so it goes much deeper than any generator.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+
+#include <glad/glad.h>
+
+
+// Whether the scene can be drawn procedurally (the Sierpinski Triangle and Levy C Curve)
+bool isProcedural(int sceneNumber);
+
+// Number of vertices the procedural draw of request needs
+GLsizei proceduralVertexCount(const FractalRequest& request);
+
+// Puts the initial primitive of the requested scene and the iteration into the uniforms of
+// program (which is left in use)
+void setProceduralUniforms(const FractalRequest& request, GLuint program);
+
+// Deepest iteration the per pixel Sierpinski Triangle is drawn at. The lattice coordinates are
+// floats, which run out of precision past 2^24 cells per side
+constexpr int PIXEL_MAX_ITERATIONS = 24;
+
+// Puts the initial triangle and iteration into the uniforms of a program using sierpinski.frag
+// (which is left in use)
+void setPixelUniforms(int iteration, GLuint program);
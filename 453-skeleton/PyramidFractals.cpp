@@ -0,0 +1,59 @@
+#include "PyramidFractals.h"
+
+
+namespace {
+
+	// Makes room for vertexCount vertices in the arrays layout uses
+	void reserve(CPU_Geometry& cpuGeom, VertexLayout layout, std::size_t vertexCount) {
+		if (layout == VertexLayout::Interleaved) {
+			cpuGeom.vertices.reserve(vertexCount);
+		}
+		else if (layout == VertexLayout::Packed) {
+			cpuGeom.packedVertices.reserve(vertexCount);
+		}
+		else {
+			cpuGeom.verts.reserve(vertexCount);
+			cpuGeom.cols.reserve(vertexCount);
+		}
+	}
+
+	// Appends the vertices of level to cpuGeom, in the arrays layout uses
+	void append(CPU_Geometry& cpuGeom, VertexLayout layout, const CPU_Geometry& level) {
+		if (layout == VertexLayout::Interleaved) {
+			cpuGeom.vertices.insert(cpuGeom.vertices.end(), level.vertices.begin(), level.vertices.end());
+		}
+		else if (layout == VertexLayout::Packed) {
+			cpuGeom.packedVertices.insert(cpuGeom.packedVertices.end(), level.packedVertices.begin(), level.packedVertices.end());
+		}
+		else {
+			cpuGeom.verts.insert(cpuGeom.verts.end(), level.verts.begin(), level.verts.end());
+			cpuGeom.cols.insert(cpuGeom.cols.end(), level.cols.begin(), level.cols.end());
+		}
+	}
+}
+
+
+bool generateFractalPyramid(const FractalRequest& request, CPU_Geometry& cpuGeom, GeneratorType generator, const GenerationContext& context) {
+	VertexLayout layout = context.format.layout;
+	GenerationContext levelContext = context;
+	levelContext.format = OutputFormat();
+	levelContext.format.layout = layout;
+
+	// Every level has a closed form size, so the output never has to grow
+	std::size_t vertexCount = 0;
+	for (int n = 0; n <= request.iteration; n++) {
+		vertexCount += fractalVertexCount({ request.sceneNumber, n });
+	}
+	reserve(cpuGeom, layout, vertexCount);
+	cpuGeom.kind = GeometryKind::Levels;
+
+	CPU_Geometry level;
+	for (int n = 0; n <= request.iteration; n++) {
+		if (!generateFractal({ request.sceneNumber, n }, level, generator, levelContext)) {
+			return false;
+		}
+		cpuGeom.levels.push_back({ GLint(countVertices(cpuGeom, layout)), GLsizei(countVertices(level, layout)) });
+		append(cpuGeom, layout, level);
+	}
+	return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a generator that writes every iteration of a scene, from
+// 0 up to the requested one, one after another into the same vertices, with a
+// table of where each of them starts (CPU_Geometry::levels).
+//
+// Uploaded once into a GPU_PyramidGeometry, changing the iteration is then just
+// drawing another range of it. All levels together take about 1.5 times the
+// vertices of the deepest for the Sierpinski Triangle and the tree, and 2 times
+// for the Levy C Curve. Every level is generated on its own, as colours depend
+// on the total number of iterations.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+
+// Replace the contents of cpuGeom with iterations 0 up to request.iteration, each generated with
+// generator as plain vertices in context.format.layout (the other format options are ignored).
+// Returns false if generation was cancelled part way through
+bool generateFractalPyramid(const FractalRequest& request, CPU_Geometry& cpuGeom, GeneratorType generator, const GenerationContext& context);
@@ -0,0 +1,136 @@
+#include "RandomAccessFractals.h"
+
+#include <stdexcept>
+
+
+namespace {
+
+	void checkIndex(int iteration, std::size_t index, std::size_t count) {
+		if (iteration > MAX_FRACTAL_DEPTH) {
+			throw std::runtime_error("Too many iterations for the random access generators.");
+		}
+		if (index >= count) {
+			throw std::runtime_error("Fractal primitive index out of range.");
+		}
+	}
+}
+
+
+/*
+* Computes one triangle of sierpinskiTriangleCreate without generating the others
+*
+* @param triangle	Initial triangle
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param index	Triangle to compute, its base 3 digits (most significant first) pick top, left or right at each step
+*
+*/
+SierpinskiTriangle sierpinskiTriangleAt(const SierpinskiTriangle& triangle, int iteration, int totalIterations, std::size_t index) {
+	checkIndex(iteration, index, sierpinskiTriangleCount(iteration));
+
+	SierpinskiTriangle current = triangle;
+	std::size_t childCount = sierpinskiTriangleCount(iteration);
+	for (; iteration > 0; iteration--) {
+		childCount /= 3;
+		current = current.subdivide(iteration, totalIterations)[index / childCount];
+		index %= childCount;
+	}
+	return current;
+}
+
+
+/*
+* Computes one line of levyCCurveCreate without generating the others
+*
+* @param line	Initial line
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param index	Line to compute, its binary digits (most significant first) pick the half at each step
+*
+*/
+LevyCCurve levyCCurveAt(const LevyCCurve& line, int iteration, int totalIterations, std::size_t index) {
+	checkIndex(iteration, index, levySegmentCount(iteration));
+
+	LevyCCurve current = line;
+	for (; iteration > 0; iteration--) {
+		std::size_t half = (index >> (iteration - 1)) & 1;
+		current = current.subdivide(iteration, totalIterations)[half];
+	}
+	return current;
+}
+
+
+/*
+* Computes one branch of treeCreate without generating the others
+*
+* @param branch		Tree trunk
+* @param iteration	Number of iterations to generate
+* @param iterationCounter	tracks number of iterations completed to detect when to start creating leaves
+* @param index	Branch to compute, in output order (the three subtrees of a branch, then the branch itself)
+*
+*/
+Tree treeBranchAt(const Tree& branch, int iteration, int iterationCounter, std::size_t index) {
+	checkIndex(iteration, index, treeBranchCount(iteration));
+
+	Tree current = branch;
+	for (; iteration > 0; iteration--) {
+		std::size_t childCount = treeBranchCount(iteration - 1);
+		if (index >= 3 * childCount) {
+			break; // The branch itself, emitted after its subtrees
+		}
+		iterationCounter++;
+		current = current.grow(iterationCounter)[index / childCount];
+		index %= childCount;
+	}
+	return current;
+}
+
+
+std::size_t fractalPrimitiveCount(const FractalRequest& request) {
+	return fractalScene(request.sceneNumber).primitiveCount(request.iteration);
+}
+
+
+// Calls write(vertex, position, colour) for every vertex of primitives [first, first + count),
+// with vertex counted from the start of the range
+template <typename Write>
+void writeFractalRange(const FractalRequest& request, std::size_t first, std::size_t count, Write&& write) {
+	if (count == 0) {
+		return;
+	}
+	if (first + count > fractalPrimitiveCount(request)) {
+		throw std::runtime_error("Fractal primitive range out of range.");
+	}
+
+	// Corners in the order of the generators, the first takes the colour of end A and the others of end B
+	const Scene& scene = fractalScene(request.sceneNumber);
+	std::size_t corners = std::size_t(scene.corners);
+	for (std::size_t i = 0; i < count; i++) {
+		SubdivisionPrimitive primitive = scene.primitiveAt(request, first + i);
+		for (std::size_t corner = 0; corner < corners; corner++) {
+			write(corners * i + corner, glm::vec3(primitive.points[corner], 0.f), primitive.colours[(corner == 0) ? 0 : 1]);
+		}
+	}
+}
+
+
+void generateFractalRange(const FractalRequest& request, std::size_t first, std::size_t count, glm::vec3* verts, glm::vec3* cols) {
+	writeFractalRange(request, first, count, [verts, cols](std::size_t v, const glm::vec3& position, const glm::vec3& colour) {
+		verts[v] = position;
+		cols[v] = colour;
+	});
+}
+
+
+void generateFractalRange(const FractalRequest& request, std::size_t first, std::size_t count, Vertex* vertices) {
+	writeFractalRange(request, first, count, [vertices](std::size_t v, const glm::vec3& position, const glm::vec3& colour) {
+		vertices[v] = { position, colour };
+	});
+}
+
+
+void generateFractalRange(const FractalRequest& request, std::size_t first, std::size_t count, PackedVertex* packedVertices) {
+	writeFractalRange(request, first, count, [packedVertices](std::size_t v, const glm::vec3& position, const glm::vec3& colour) {
+		packedVertices[v] = packVertex(position, colour);
+	});
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains random access versions of the fractal generators.
+//
+// The path from the root to a primitive is spelled out by its index: base 3
+// digits pick the child triangle of every Sierpinski Triangle step, binary
+// digits pick the half of every Levy C Curve step, and the tree is indexed in
+// the order the generators emit it (children before their parent). So any
+// primitive can be computed on its own in O(depth), and any range of the
+// output can be produced independently of the rest (by separate threads, per
+// tile, or only for what is visible).
+//
+// Primitives are computed with the same subdivide/grow steps as the recursive
+// generators, so the output is the same, byte for byte.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+
+// Primitive number index of the output of the corresponding generator.
+// Throw std::runtime_error if index is past the end or iteration is above MAX_FRACTAL_DEPTH
+SierpinskiTriangle sierpinskiTriangleAt(const SierpinskiTriangle& triangle, int iteration, int totalIterations, std::size_t index);
+LevyCCurve levyCCurveAt(const LevyCCurve& line, int iteration, int totalIterations, std::size_t index);
+Tree treeBranchAt(const Tree& branch, int iteration, int iterationCounter, std::size_t index);
+
+// Number of primitives in the requested scene
+std::size_t fractalPrimitiveCount(const FractalRequest& request);
+
+// Writes primitives [first, first + count) of the requested scene into vertex and colour arrays
+// laid out the way GPU_Geometry expects them (3 vertices per triangle, 2 per line), starting at
+// verts[0] and cols[0]. Throws std::runtime_error if the range is past the end
+void generateFractalRange(const FractalRequest& request, std::size_t first, std::size_t count, glm::vec3* verts, glm::vec3* cols);
+void generateFractalRange(const FractalRequest& request, std::size_t first, std::size_t count, Vertex* vertices); // Interleaved
+void generateFractalRange(const FractalRequest& request, std::size_t first, std::size_t count, PackedVertex* packedVertices); // Packed
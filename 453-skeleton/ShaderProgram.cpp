@@ -8,11 +8,46 @@
 
 ShaderProgram::ShaderProgram(const std::string& vertexPath, const std::string& fragmentPath)
 	: programID()
-	, vertex(vertexPath, GL_VERTEX_SHADER)
-	, fragment(fragmentPath, GL_FRAGMENT_SHADER)
+	, vertex(std::in_place, vertexPath, GL_VERTEX_SHADER)
+	, fragment(std::in_place, fragmentPath, GL_FRAGMENT_SHADER)
 {
-	attach(*this, vertex);
-	attach(*this, fragment);
+	link();
+}
+
+ShaderProgram::ShaderProgram(const std::string& vertexPath, const std::vector<std::string>& feedbackVaryings, GLenum feedbackMode)
+	: programID()
+	, vertex(std::in_place, vertexPath, GL_VERTEX_SHADER)
+	, fragment()
+	, feedbackVaryings(feedbackVaryings)
+	, feedbackMode(feedbackMode)
+{
+	link();
+}
+
+#ifdef USE_OPENGL_4_6
+ShaderProgram::ShaderProgram(const std::string& computePath)
+	: programID()
+	, compute(std::in_place, computePath, GL_COMPUTE_SHADER)
+{
+	link();
+}
+#endif
+
+void ShaderProgram::link() {
+	for (std::optional<Shader>* shader : { &vertex, &fragment, &compute }) {
+		if (*shader) {
+			attach(*this, **shader);
+		}
+	}
+
+	// Has to be set before linking
+	if (!feedbackVaryings.empty()) {
+		std::vector<const char*> names;
+		for (const std::string& name : feedbackVaryings) {
+			names.push_back(name.c_str());
+		}
+		glTransformFeedbackVaryings(programID, GLsizei(names.size()), names.data(), feedbackMode);
+	}
 	glLinkProgram(programID);
 
 	if (!checkAndLogLinkSuccess()) {
@@ -25,7 +60,15 @@ bool ShaderProgram::recompile() {
 
 	try {
 		// Try to create a new program
-		ShaderProgram newProgram(vertex.getPath(), fragment.getPath());
+#ifdef USE_OPENGL_4_6
+		if (compute) {
+			*this = ShaderProgram(compute->getPath());
+			return true;
+		}
+#endif
+		ShaderProgram newProgram = fragment
+			? ShaderProgram(vertex->getPath(), fragment->getPath())
+			: ShaderProgram(vertex->getPath(), feedbackVaryings, feedbackMode);
 		*this = std::move(newProgram);
 		return true;
 	}
@@ -41,6 +84,14 @@ void attach(ShaderProgram& sp, Shader& s) {
 }
 
 
+std::string ShaderProgram::describe() const {
+	if (compute) {
+		return compute->getPath();
+	}
+	return vertex->getPath() + " + " + (fragment ? fragment->getPath() : std::string("transform feedback"));
+}
+
+
 bool ShaderProgram::checkAndLogLinkSuccess() const {
 
 	GLint success;
@@ -52,17 +103,15 @@ bool ShaderProgram::checkAndLogLinkSuccess() const {
 		std::vector<char> log(logLength);
 		glGetProgramInfoLog(programID, logLength, NULL, log.data());
 
-		Log::error("SHADER_PROGRAM linking {} + {}:\n{}",
-			  vertex.getPath()
-			, fragment.getPath()
+		Log::error("SHADER_PROGRAM linking {}:\n{}",
+			  describe()
 			, log.data()
 		);
 		return false;
 	}
 	else {
-		Log::info("SHADER_PROGRAM successfully compiled and linked {} + {}",
-			  vertex.getPath()
-			, fragment.getPath()
+		Log::info("SHADER_PROGRAM successfully compiled and linked {}",
+			  describe()
 		);
 		return true;
 	}
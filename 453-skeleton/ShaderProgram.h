@@ -8,12 +8,20 @@
 
 #include <string>
 #include <optional>
+#include <vector>
 
 
 class ShaderProgram {
 
 public:
 	ShaderProgram(const std::string& vertexPath, const std::string& fragmentPath);
+	// Vertex shader only, for transform feedback with GL_RASTERIZER_DISCARD. The outputs named in
+	// feedbackVaryings are captured in feedbackMode (GL_INTERLEAVED_ATTRIBS or GL_SEPARATE_ATTRIBS)
+	ShaderProgram(const std::string& vertexPath, const std::vector<std::string>& feedbackVaryings, GLenum feedbackMode);
+#ifdef USE_OPENGL_4_6
+	// Compute shader only
+	explicit ShaderProgram(const std::string& computePath);
+#endif
 	// Because we're using the ShaderProgramHandle to do RAII for the shader for us
 	// and our other types are trivial or provide their own RAII
 	// we don't have to provide any specialized functions here. Rule of zero
@@ -34,8 +42,14 @@ public:
 private:
 	ShaderProgramHandle programID;
 
-	Shader vertex;
-	Shader fragment;
+	std::optional<Shader> vertex; // Not set for compute programs
+	std::optional<Shader> fragment; // Only set for programs that rasterize
+	std::optional<Shader> compute;
 
+	std::vector<std::string> feedbackVaryings;
+	GLenum feedbackMode = GL_INTERLEAVED_ATTRIBS;
+
+	void link();
+	std::string describe() const; // Shader paths, for the log
 	bool checkAndLogLinkSuccess() const;
 };
@@ -0,0 +1,575 @@
+#include "SimdFractals.h"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FRACTALS_X86_64
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define FRACTALS_TARGET_AVX2
+#else
+#define FRACTALS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+
+//------------------------------------------------------------------------------
+// Level storage
+//
+// A level is stored child-major: child c of parent k at level L is stored at
+// index c * (size of level L - 1) + k. This keeps every kernel store contiguous,
+// but means a level holds its primitives in digit reversed order, which is undone
+// while writing the vertex arrays.
+//------------------------------------------------------------------------------
+
+namespace {
+
+	struct SierpinskiLevel {
+		float* ax; float* ay; // Vertex A
+		float* bx; float* by; // Vertex B
+		float* cx; float* cy; // Vertex C
+		float* g; float* b; // Colour (red never changes)
+
+		static constexpr std::size_t ARRAYS = 8;
+
+		SierpinskiLevel(std::vector<float>& storage, std::size_t count) {
+			storage.resize(ARRAYS * count);
+			float* p = storage.data();
+			ax = p; ay = p + count;
+			bx = p + 2 * count; by = p + 3 * count;
+			cx = p + 4 * count; cy = p + 5 * count;
+			g = p + 6 * count; b = p + 7 * count;
+		}
+	};
+
+	struct LevyLevel {
+		float* ax; float* ay; // Vertex A
+		float* bx; float* by; // Vertex B
+		float* ar; float* ag; float* ab; // Colour at A
+		float* br; float* bg; float* bb; // Colour at B
+
+		static constexpr std::size_t ARRAYS = 10;
+
+		LevyLevel(std::vector<float>& storage, std::size_t count) {
+			storage.resize(ARRAYS * count);
+			float* p = storage.data();
+			ax = p; ay = p + count;
+			bx = p + 2 * count; by = p + 3 * count;
+			ar = p + 4 * count; ag = p + 5 * count; ab = p + 6 * count;
+			br = p + 7 * count; bg = p + 8 * count; bb = p + 9 * count;
+		}
+	};
+
+
+	//------------------------------------------------------------------------------
+	// Scalar kernels. Also used for the tail of each level by the SIMD kernels.
+	// The arithmetic (and its order) matches SierpinskiTriangle::subdivide and
+	// LevyCCurve::subdivide exactly.
+	//------------------------------------------------------------------------------
+
+	void sierpinskiKernelScalar(const SierpinskiLevel& in, const SierpinskiLevel& out, std::size_t begin, std::size_t end, std::size_t parents, float increment) {
+		for (std::size_t k = begin; k < end; k++) {
+			float ax = in.ax[k], ay = in.ay[k];
+			float bx = in.bx[k], by = in.by[k];
+			float cx = in.cx[k], cy = in.cy[k];
+			float g = in.g[k], b = in.b[k];
+
+			// New vertices from midpoins of triangle sides
+			float dx = 0.5f * (ax + cx), dy = 0.5f * (ay + cy);
+			float ex = 0.5f * (cx + bx), ey = 0.5f * (cy + by);
+			float fx = 0.5f * (bx + ax), fy = 0.5f * (by + ay);
+
+			// Top (D, E, C), decrease green
+			std::size_t i = k;
+			out.ax[i] = dx; out.ay[i] = dy; out.bx[i] = ex; out.by[i] = ey; out.cx[i] = cx; out.cy[i] = cy;
+			out.g[i] = g - increment; out.b[i] = b;
+
+			// Left (F, B, E), increase blue
+			i += parents;
+			out.ax[i] = fx; out.ay[i] = fy; out.bx[i] = bx; out.by[i] = by; out.cx[i] = ex; out.cy[i] = ey;
+			out.g[i] = g; out.b[i] = b + increment;
+
+			// Right (A, F, D), decrease blue
+			i += parents;
+			out.ax[i] = ax; out.ay[i] = ay; out.bx[i] = fx; out.by[i] = fy; out.cx[i] = dx; out.cy[i] = dy;
+			out.g[i] = g; out.b[i] = b - increment;
+		}
+	}
+
+	void levyKernelScalar(const LevyLevel& in, const LevyLevel& out, std::size_t begin, std::size_t end, std::size_t parents, float colourMidpoint) {
+		float oneMinusMidpoint = 1.f - colourMidpoint;
+		for (std::size_t k = begin; k < end; k++) {
+			float ax = in.ax[k], ay = in.ay[k];
+			float bx = in.bx[k], by = in.by[k];
+
+			// New vertex C
+			float lengthX = bx - ax;
+			float lengthY = by - ay;
+			float newX = ax + lengthX * 0.5f - lengthY * 0.5f;
+			float newY = ay + lengthY * 0.5f + lengthX * 0.5f;
+
+			// glm::mix(colourA, colourB, colourMidpoint)
+			float r = in.ar[k] * oneMinusMidpoint + in.br[k] * colourMidpoint;
+			float g = in.ag[k] * oneMinusMidpoint + in.bg[k] * colourMidpoint;
+			float b = in.ab[k] * oneMinusMidpoint + in.bb[k] * colourMidpoint;
+
+			// Left line (A, C)
+			std::size_t i = k;
+			out.ax[i] = ax; out.ay[i] = ay; out.bx[i] = newX; out.by[i] = newY;
+			out.ar[i] = in.ar[k]; out.ag[i] = in.ag[k]; out.ab[i] = in.ab[k];
+			out.br[i] = r; out.bg[i] = g; out.bb[i] = b;
+
+			// Right line (C, B)
+			i += parents;
+			out.ax[i] = newX; out.ay[i] = newY; out.bx[i] = bx; out.by[i] = by;
+			out.ar[i] = r; out.ag[i] = g; out.ab[i] = b;
+			out.br[i] = in.br[k]; out.bg[i] = in.bg[k]; out.bb[i] = in.bb[k];
+		}
+	}
+
+
+#ifdef FRACTALS_X86_64
+
+	//------------------------------------------------------------------------------
+	// SSE kernels (4 primitives at a time, always available on x86-64)
+	//------------------------------------------------------------------------------
+
+	void sierpinskiKernelSSE(const SierpinskiLevel& in, const SierpinskiLevel& out, std::size_t parents, float increment) {
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 inc = _mm_set1_ps(increment);
+
+		std::size_t k = 0;
+		for (; k + 4 <= parents; k += 4) {
+			__m128 ax = _mm_loadu_ps(in.ax + k), ay = _mm_loadu_ps(in.ay + k);
+			__m128 bx = _mm_loadu_ps(in.bx + k), by = _mm_loadu_ps(in.by + k);
+			__m128 cx = _mm_loadu_ps(in.cx + k), cy = _mm_loadu_ps(in.cy + k);
+			__m128 g = _mm_loadu_ps(in.g + k), b = _mm_loadu_ps(in.b + k);
+
+			__m128 dx = _mm_mul_ps(half, _mm_add_ps(ax, cx)), dy = _mm_mul_ps(half, _mm_add_ps(ay, cy));
+			__m128 ex = _mm_mul_ps(half, _mm_add_ps(cx, bx)), ey = _mm_mul_ps(half, _mm_add_ps(cy, by));
+			__m128 fx = _mm_mul_ps(half, _mm_add_ps(bx, ax)), fy = _mm_mul_ps(half, _mm_add_ps(by, ay));
+
+			std::size_t i = k;
+			_mm_storeu_ps(out.ax + i, dx); _mm_storeu_ps(out.ay + i, dy);
+			_mm_storeu_ps(out.bx + i, ex); _mm_storeu_ps(out.by + i, ey);
+			_mm_storeu_ps(out.cx + i, cx); _mm_storeu_ps(out.cy + i, cy);
+			_mm_storeu_ps(out.g + i, _mm_sub_ps(g, inc)); _mm_storeu_ps(out.b + i, b);
+
+			i += parents;
+			_mm_storeu_ps(out.ax + i, fx); _mm_storeu_ps(out.ay + i, fy);
+			_mm_storeu_ps(out.bx + i, bx); _mm_storeu_ps(out.by + i, by);
+			_mm_storeu_ps(out.cx + i, ex); _mm_storeu_ps(out.cy + i, ey);
+			_mm_storeu_ps(out.g + i, g); _mm_storeu_ps(out.b + i, _mm_add_ps(b, inc));
+
+			i += parents;
+			_mm_storeu_ps(out.ax + i, ax); _mm_storeu_ps(out.ay + i, ay);
+			_mm_storeu_ps(out.bx + i, fx); _mm_storeu_ps(out.by + i, fy);
+			_mm_storeu_ps(out.cx + i, dx); _mm_storeu_ps(out.cy + i, dy);
+			_mm_storeu_ps(out.g + i, g); _mm_storeu_ps(out.b + i, _mm_sub_ps(b, inc));
+		}
+		sierpinskiKernelScalar(in, out, k, parents, parents, increment);
+	}
+
+	void levyKernelSSE(const LevyLevel& in, const LevyLevel& out, std::size_t parents, float colourMidpoint) {
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 t = _mm_set1_ps(colourMidpoint);
+		const __m128 oneMinusT = _mm_set1_ps(1.f - colourMidpoint);
+
+		std::size_t k = 0;
+		for (; k + 4 <= parents; k += 4) {
+			__m128 ax = _mm_loadu_ps(in.ax + k), ay = _mm_loadu_ps(in.ay + k);
+			__m128 bx = _mm_loadu_ps(in.bx + k), by = _mm_loadu_ps(in.by + k);
+			__m128 ar = _mm_loadu_ps(in.ar + k), ag = _mm_loadu_ps(in.ag + k), ab = _mm_loadu_ps(in.ab + k);
+			__m128 br = _mm_loadu_ps(in.br + k), bg = _mm_loadu_ps(in.bg + k), bb = _mm_loadu_ps(in.bb + k);
+
+			__m128 halfX = _mm_mul_ps(_mm_sub_ps(bx, ax), half);
+			__m128 halfY = _mm_mul_ps(_mm_sub_ps(by, ay), half);
+			__m128 newX = _mm_sub_ps(_mm_add_ps(ax, halfX), halfY);
+			__m128 newY = _mm_add_ps(_mm_add_ps(ay, halfY), halfX);
+
+			__m128 r = _mm_add_ps(_mm_mul_ps(ar, oneMinusT), _mm_mul_ps(br, t));
+			__m128 g = _mm_add_ps(_mm_mul_ps(ag, oneMinusT), _mm_mul_ps(bg, t));
+			__m128 b = _mm_add_ps(_mm_mul_ps(ab, oneMinusT), _mm_mul_ps(bb, t));
+
+			std::size_t i = k;
+			_mm_storeu_ps(out.ax + i, ax); _mm_storeu_ps(out.ay + i, ay);
+			_mm_storeu_ps(out.bx + i, newX); _mm_storeu_ps(out.by + i, newY);
+			_mm_storeu_ps(out.ar + i, ar); _mm_storeu_ps(out.ag + i, ag); _mm_storeu_ps(out.ab + i, ab);
+			_mm_storeu_ps(out.br + i, r); _mm_storeu_ps(out.bg + i, g); _mm_storeu_ps(out.bb + i, b);
+
+			i += parents;
+			_mm_storeu_ps(out.ax + i, newX); _mm_storeu_ps(out.ay + i, newY);
+			_mm_storeu_ps(out.bx + i, bx); _mm_storeu_ps(out.by + i, by);
+			_mm_storeu_ps(out.ar + i, r); _mm_storeu_ps(out.ag + i, g); _mm_storeu_ps(out.ab + i, b);
+			_mm_storeu_ps(out.br + i, br); _mm_storeu_ps(out.bg + i, bg); _mm_storeu_ps(out.bb + i, bb);
+		}
+		levyKernelScalar(in, out, k, parents, parents, colourMidpoint);
+	}
+
+
+	//------------------------------------------------------------------------------
+	// AVX2 kernels (8 primitives at a time)
+	//------------------------------------------------------------------------------
+
+	FRACTALS_TARGET_AVX2
+	void sierpinskiKernelAVX2(const SierpinskiLevel& in, const SierpinskiLevel& out, std::size_t parents, float increment) {
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 inc = _mm256_set1_ps(increment);
+
+		std::size_t k = 0;
+		for (; k + 8 <= parents; k += 8) {
+			__m256 ax = _mm256_loadu_ps(in.ax + k), ay = _mm256_loadu_ps(in.ay + k);
+			__m256 bx = _mm256_loadu_ps(in.bx + k), by = _mm256_loadu_ps(in.by + k);
+			__m256 cx = _mm256_loadu_ps(in.cx + k), cy = _mm256_loadu_ps(in.cy + k);
+			__m256 g = _mm256_loadu_ps(in.g + k), b = _mm256_loadu_ps(in.b + k);
+
+			__m256 dx = _mm256_mul_ps(half, _mm256_add_ps(ax, cx)), dy = _mm256_mul_ps(half, _mm256_add_ps(ay, cy));
+			__m256 ex = _mm256_mul_ps(half, _mm256_add_ps(cx, bx)), ey = _mm256_mul_ps(half, _mm256_add_ps(cy, by));
+			__m256 fx = _mm256_mul_ps(half, _mm256_add_ps(bx, ax)), fy = _mm256_mul_ps(half, _mm256_add_ps(by, ay));
+
+			std::size_t i = k;
+			_mm256_storeu_ps(out.ax + i, dx); _mm256_storeu_ps(out.ay + i, dy);
+			_mm256_storeu_ps(out.bx + i, ex); _mm256_storeu_ps(out.by + i, ey);
+			_mm256_storeu_ps(out.cx + i, cx); _mm256_storeu_ps(out.cy + i, cy);
+			_mm256_storeu_ps(out.g + i, _mm256_sub_ps(g, inc)); _mm256_storeu_ps(out.b + i, b);
+
+			i += parents;
+			_mm256_storeu_ps(out.ax + i, fx); _mm256_storeu_ps(out.ay + i, fy);
+			_mm256_storeu_ps(out.bx + i, bx); _mm256_storeu_ps(out.by + i, by);
+			_mm256_storeu_ps(out.cx + i, ex); _mm256_storeu_ps(out.cy + i, ey);
+			_mm256_storeu_ps(out.g + i, g); _mm256_storeu_ps(out.b + i, _mm256_add_ps(b, inc));
+
+			i += parents;
+			_mm256_storeu_ps(out.ax + i, ax); _mm256_storeu_ps(out.ay + i, ay);
+			_mm256_storeu_ps(out.bx + i, fx); _mm256_storeu_ps(out.by + i, fy);
+			_mm256_storeu_ps(out.cx + i, dx); _mm256_storeu_ps(out.cy + i, dy);
+			_mm256_storeu_ps(out.g + i, g); _mm256_storeu_ps(out.b + i, _mm256_sub_ps(b, inc));
+		}
+		sierpinskiKernelScalar(in, out, k, parents, parents, increment);
+	}
+
+	FRACTALS_TARGET_AVX2
+	void levyKernelAVX2(const LevyLevel& in, const LevyLevel& out, std::size_t parents, float colourMidpoint) {
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 t = _mm256_set1_ps(colourMidpoint);
+		const __m256 oneMinusT = _mm256_set1_ps(1.f - colourMidpoint);
+
+		std::size_t k = 0;
+		for (; k + 8 <= parents; k += 8) {
+			__m256 ax = _mm256_loadu_ps(in.ax + k), ay = _mm256_loadu_ps(in.ay + k);
+			__m256 bx = _mm256_loadu_ps(in.bx + k), by = _mm256_loadu_ps(in.by + k);
+			__m256 ar = _mm256_loadu_ps(in.ar + k), ag = _mm256_loadu_ps(in.ag + k), ab = _mm256_loadu_ps(in.ab + k);
+			__m256 br = _mm256_loadu_ps(in.br + k), bg = _mm256_loadu_ps(in.bg + k), bb = _mm256_loadu_ps(in.bb + k);
+
+			__m256 halfX = _mm256_mul_ps(_mm256_sub_ps(bx, ax), half);
+			__m256 halfY = _mm256_mul_ps(_mm256_sub_ps(by, ay), half);
+			__m256 newX = _mm256_sub_ps(_mm256_add_ps(ax, halfX), halfY);
+			__m256 newY = _mm256_add_ps(_mm256_add_ps(ay, halfY), halfX);
+
+			__m256 r = _mm256_add_ps(_mm256_mul_ps(ar, oneMinusT), _mm256_mul_ps(br, t));
+			__m256 g = _mm256_add_ps(_mm256_mul_ps(ag, oneMinusT), _mm256_mul_ps(bg, t));
+			__m256 b = _mm256_add_ps(_mm256_mul_ps(ab, oneMinusT), _mm256_mul_ps(bb, t));
+
+			std::size_t i = k;
+			_mm256_storeu_ps(out.ax + i, ax); _mm256_storeu_ps(out.ay + i, ay);
+			_mm256_storeu_ps(out.bx + i, newX); _mm256_storeu_ps(out.by + i, newY);
+			_mm256_storeu_ps(out.ar + i, ar); _mm256_storeu_ps(out.ag + i, ag); _mm256_storeu_ps(out.ab + i, ab);
+			_mm256_storeu_ps(out.br + i, r); _mm256_storeu_ps(out.bg + i, g); _mm256_storeu_ps(out.bb + i, b);
+
+			i += parents;
+			_mm256_storeu_ps(out.ax + i, newX); _mm256_storeu_ps(out.ay + i, newY);
+			_mm256_storeu_ps(out.bx + i, bx); _mm256_storeu_ps(out.by + i, by);
+			_mm256_storeu_ps(out.ar + i, r); _mm256_storeu_ps(out.ag + i, g); _mm256_storeu_ps(out.ab + i, b);
+			_mm256_storeu_ps(out.br + i, br); _mm256_storeu_ps(out.bg + i, bg); _mm256_storeu_ps(out.bb + i, bb);
+		}
+		levyKernelScalar(in, out, k, parents, parents, colourMidpoint);
+	}
+
+#endif // FRACTALS_X86_64
+
+
+	void sierpinskiKernel(SimdKernel kernel, const SierpinskiLevel& in, const SierpinskiLevel& out, std::size_t parents, float increment) {
+		switch (kernel) {
+#ifdef FRACTALS_X86_64
+		case SimdKernel::AVX2: sierpinskiKernelAVX2(in, out, parents, increment); break;
+		case SimdKernel::SSE: sierpinskiKernelSSE(in, out, parents, increment); break;
+#endif
+		default: sierpinskiKernelScalar(in, out, 0, parents, parents, increment); break;
+		}
+	}
+
+	void levyKernel(SimdKernel kernel, const LevyLevel& in, const LevyLevel& out, std::size_t parents, float colourMidpoint) {
+		switch (kernel) {
+#ifdef FRACTALS_X86_64
+		case SimdKernel::AVX2: levyKernelAVX2(in, out, parents, colourMidpoint); break;
+		case SimdKernel::SSE: levyKernelSSE(in, out, parents, colourMidpoint); break;
+#endif
+		default: levyKernelScalar(in, out, 0, parents, parents, colourMidpoint); break;
+		}
+	}
+
+
+	// Visits 0 .. count - 1 in order together with the same index with its base-digits reversed.
+	// Reversing the digits maps between the child-major storage order of a level and the
+	// recursive (depth first) output order, in both directions
+	template <typename Visit>
+	void forEachDigitReversed(std::size_t count, int digitCount, std::size_t base, Visit&& visit) {
+		std::array<std::size_t, 64> digits{};
+		std::array<std::size_t, 64> weights{};
+		for (int i = 0; i < digitCount; i++) {
+			weights[digitCount - 1 - i] = (i == 0) ? 1 : weights[digitCount - i] * base;
+		}
+
+		std::size_t reversed = 0;
+		for (std::size_t index = 0; index < count; index++) {
+			visit(index, reversed);
+
+			for (int digit = 0; digit < digitCount; digit++) {
+				reversed += weights[digit];
+				if (++digits[digit] < base) {
+					break;
+				}
+				reversed -= base * weights[digit];
+				digits[digit] = 0;
+			}
+		}
+	}
+
+
+	// Subdivides level (holding count primitives) levels times, starting at remaining iterations
+	// still to go. Returns the final level, which lives in either current or next
+	SierpinskiLevel expandSierpinski(SierpinskiLevel level, std::size_t& count, int remaining, int levels, int totalIterations, SimdKernel kernel, std::vector<float>& current, std::vector<float>& next) {
+		for (int i = 0; i < levels; i++, remaining--) {
+			float increment = (static_cast<float>(remaining) / totalIterations) * 0.33f; // Colour incremented based on iterations
+
+			SierpinskiLevel children(next, 3 * count);
+			sierpinskiKernel(kernel, level, children, count, increment);
+
+			std::swap(current, next);
+			level = children;
+			count *= 3;
+		}
+		return level;
+	}
+
+	LevyLevel expandLevy(LevyLevel level, std::size_t& count, int remaining, int levels, int totalIterations, SimdKernel kernel, std::vector<float>& current, std::vector<float>& next) {
+		for (int i = 0; i < levels; i++, remaining--) {
+			// Normalize iteration range so that each iteration has a value between 0 and 1
+			float colourMidpoint = (static_cast<float>(totalIterations) - remaining) / totalIterations;
+
+			LevyLevel children(next, 2 * count);
+			levyKernel(kernel, level, children, count, colourMidpoint);
+
+			std::swap(current, next);
+			level = children;
+			count *= 2;
+		}
+		return level;
+	}
+
+	void copyPrimitive(const SierpinskiLevel& from, std::size_t i, const SierpinskiLevel& to, std::size_t j) {
+		to.ax[j] = from.ax[i]; to.ay[j] = from.ay[i];
+		to.bx[j] = from.bx[i]; to.by[j] = from.by[i];
+		to.cx[j] = from.cx[i]; to.cy[j] = from.cy[i];
+		to.g[j] = from.g[i]; to.b[j] = from.b[i];
+	}
+
+	void copyPrimitive(const LevyLevel& from, std::size_t i, const LevyLevel& to, std::size_t j) {
+		to.ax[j] = from.ax[i]; to.ay[j] = from.ay[i];
+		to.bx[j] = from.bx[i]; to.by[j] = from.by[i];
+		to.ar[j] = from.ar[i]; to.ag[j] = from.ag[i]; to.ab[j] = from.ab[i];
+		to.br[j] = from.br[i]; to.bg[j] = from.bg[i]; to.bb[j] = from.bb[i];
+	}
+
+	// Subtrees of this many levels are expanded and written out one at a time, so that
+	// undoing the digit reversal only scatters writes within a block that fits in cache
+	constexpr int SIERPINSKI_BLOCK_LEVELS = 6; // 729 triangles
+	constexpr int LEVY_BLOCK_LEVELS = 10; // 1024 lines
+}
+
+
+//------------------------------------------------------------------------------
+
+
+SimdKernel bestSimdKernel() {
+#ifdef FRACTALS_X86_64
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] >= 7) {
+		__cpuid(info, 1);
+		bool osSavesAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+		__cpuidex(info, 7, 0);
+		if (osSavesAvx && (info[1] & (1 << 5))) {
+			return SimdKernel::AVX2;
+		}
+	}
+#else
+	if (__builtin_cpu_supports("avx2")) {
+		return SimdKernel::AVX2;
+	}
+#endif
+	return SimdKernel::SSE;
+#else
+	return SimdKernel::Scalar;
+#endif
+}
+
+
+const char* simdKernelName(SimdKernel kernel) {
+	switch (kernel) {
+	case SimdKernel::AVX2: return "AVX2";
+	case SimdKernel::SSE: return "SSE";
+	default: return "scalar";
+	}
+}
+
+
+/*
+* Creates vertices and colours for Sierpinski Triangle one level at a time
+*
+* @param triangle	Initial triangle
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param verts	Output vertex positions
+* @param cols	Output vertex colours
+* @param kernel	Instruction set to use (see bestSimdKernel)
+* @param cancelled	Optional flag, generation stops early once it is set
+* @param arena	Optional scratch memory to keep the level buffers in
+*
+*/
+bool sierpinskiTriangleCreateSimd(const SierpinskiTriangle& triangle, int iteration, int totalIterations, glm::vec3* verts, glm::vec3* cols, SimdKernel kernel, const std::atomic<bool>* cancelled, GenerationArena* arena) {
+	int blockLevels = (iteration < SIERPINSKI_BLOCK_LEVELS) ? iteration : SIERPINSKI_BLOCK_LEVELS;
+	int topLevels = iteration - blockLevels;
+
+	// Level buffers, reused between calls when an arena is given
+	GenerationArena localArena;
+	std::array<std::vector<float>, 4>& levels = (arena != nullptr) ? arena->levels : localArena.levels;
+	std::vector<float>& topCurrent = levels[0];
+	std::vector<float>& topNext = levels[1];
+	std::vector<float>& blockCurrent = levels[2];
+	std::vector<float>& blockNext = levels[3];
+
+	// Expand everything above the blocks breadth first
+	SierpinskiLevel top(topCurrent, 1);
+	top.ax[0] = triangle.A.x; top.ay[0] = triangle.A.y;
+	top.bx[0] = triangle.B.x; top.by[0] = triangle.B.y;
+	top.cx[0] = triangle.C.x; top.cy[0] = triangle.C.y;
+	top.g[0] = triangle.colour.y; top.b[0] = triangle.colour.z;
+
+	std::size_t topCount = 1;
+	top = expandSierpinski(top, topCount, iteration, topLevels, totalIterations, kernel, topCurrent, topNext);
+
+	// Then each block in output order
+	float red = triangle.colour.x;
+
+	forEachDigitReversed(topCount, topLevels, 3, [&](std::size_t blockIndex, std::size_t topIndex) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		SierpinskiLevel block(blockCurrent, 1);
+		copyPrimitive(top, topIndex, block, 0);
+		std::size_t blockCount = 1;
+		block = expandSierpinski(block, blockCount, blockLevels, blockLevels, totalIterations, kernel, blockCurrent, blockNext);
+
+		glm::vec3* blockVerts = verts + 3 * blockIndex * blockCount;
+		glm::vec3* blockCols = cols + 3 * blockIndex * blockCount;
+		forEachDigitReversed(blockCount, blockLevels, 3, [&](std::size_t s, std::size_t j) {
+			glm::vec3* v = blockVerts + 3 * j;
+			v[0] = glm::vec3(block.ax[s], block.ay[s], 0.f); // Lower Left
+			v[1] = glm::vec3(block.bx[s], block.by[s], 0.f); // Lower Right
+			v[2] = glm::vec3(block.cx[s], block.cy[s], 0.f); // Upper
+
+			glm::vec3 colour(red, block.g[s], block.b[s]);
+			glm::vec3* c = blockCols + 3 * j;
+			c[0] = colour;
+			c[1] = colour;
+			c[2] = colour;
+		});
+	});
+	return !isCancelled(cancelled);
+}
+
+
+/*
+* Creates vertices and colours for Levy C Curve one level at a time
+*
+* @param line	Initial line
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param verts	Output vertex positions
+* @param cols	Output vertex colours
+* @param kernel	Instruction set to use (see bestSimdKernel)
+* @param cancelled	Optional flag, generation stops early once it is set
+* @param arena	Optional scratch memory to keep the level buffers in
+*
+*/
+bool levyCCurveCreateSimd(const LevyCCurve& line, int iteration, int totalIterations, glm::vec3* verts, glm::vec3* cols, SimdKernel kernel, const std::atomic<bool>* cancelled, GenerationArena* arena) {
+	int blockLevels = (iteration < LEVY_BLOCK_LEVELS) ? iteration : LEVY_BLOCK_LEVELS;
+	int topLevels = iteration - blockLevels;
+
+	// Level buffers, reused between calls when an arena is given
+	GenerationArena localArena;
+	std::array<std::vector<float>, 4>& levels = (arena != nullptr) ? arena->levels : localArena.levels;
+	std::vector<float>& topCurrent = levels[0];
+	std::vector<float>& topNext = levels[1];
+	std::vector<float>& blockCurrent = levels[2];
+	std::vector<float>& blockNext = levels[3];
+
+	// Expand everything above the blocks breadth first
+	LevyLevel top(topCurrent, 1);
+	top.ax[0] = line.A.x; top.ay[0] = line.A.y;
+	top.bx[0] = line.B.x; top.by[0] = line.B.y;
+	top.ar[0] = line.colourA.x; top.ag[0] = line.colourA.y; top.ab[0] = line.colourA.z;
+	top.br[0] = line.colourB.x; top.bg[0] = line.colourB.y; top.bb[0] = line.colourB.z;
+
+	std::size_t topCount = 1;
+	top = expandLevy(top, topCount, iteration, topLevels, totalIterations, kernel, topCurrent, topNext);
+
+	// Then each block in output order
+
+	forEachDigitReversed(topCount, topLevels, 2, [&](std::size_t blockIndex, std::size_t topIndex) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		LevyLevel block(blockCurrent, 1);
+		copyPrimitive(top, topIndex, block, 0);
+		std::size_t blockCount = 1;
+		block = expandLevy(block, blockCount, blockLevels, blockLevels, totalIterations, kernel, blockCurrent, blockNext);
+
+		glm::vec3* blockVerts = verts + 2 * blockIndex * blockCount;
+		glm::vec3* blockCols = cols + 2 * blockIndex * blockCount;
+		forEachDigitReversed(blockCount, blockLevels, 2, [&](std::size_t s, std::size_t j) {
+			glm::vec3* v = blockVerts + 2 * j;
+			v[0] = glm::vec3(block.ax[s], block.ay[s], 0.f); // Left point
+			v[1] = glm::vec3(block.bx[s], block.by[s], 0.f); // Right point
+
+			glm::vec3* c = blockCols + 2 * j;
+			c[0] = glm::vec3(block.ar[s], block.ag[s], block.ab[s]);
+			c[1] = glm::vec3(block.br[s], block.bg[s], block.bb[s]);
+		});
+	});
+	return !isCancelled(cancelled);
+}
+
+
+void sierpinskiTriangleCreateSimd(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled, GenerationArena* arena) {
+	std::size_t vertexCount = 3 * sierpinskiTriangleCount(iteration);
+	cpuGeom.verts.resize(vertexCount);
+	cpuGeom.cols.resize(vertexCount);
+	sierpinskiTriangleCreateSimd(triangle, iteration, totalIterations, cpuGeom.verts.data(), cpuGeom.cols.data(), bestSimdKernel(), cancelled, arena);
+}
+
+
+void levyCCurveCreateSimd(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled, GenerationArena* arena) {
+	std::size_t vertexCount = 2 * levySegmentCount(iteration);
+	cpuGeom.verts.resize(vertexCount);
+	cpuGeom.cols.resize(vertexCount);
+	levyCCurveCreateSimd(line, iteration, totalIterations, cpuGeom.verts.data(), cpuGeom.cols.data(), bestSimdKernel(), cancelled, arena);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains breadth first (one whole level at a time) versions of the
+// Sierpinski Triangle and Levy C Curve generators.
+//
+// Every level is kept in structure-of-arrays form (one float array per vertex
+// coordinate and colour channel), so the midpoint and rotation arithmetic runs
+// as SSE or AVX2 kernels over the whole level. The kernel is picked at runtime
+// based on what the CPU supports, with a plain scalar fallback.
+//
+// The figures lie in the z = 0 plane. The output is the same, byte for byte,
+// as the recursive generators.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+
+
+enum class SimdKernel {
+	Scalar,
+	SSE,
+	AVX2
+};
+
+// Widest kernel supported by this CPU
+SimdKernel bestSimdKernel();
+const char* simdKernelName(SimdKernel kernel);
+
+
+// Replace the contents of cpuGeom. Level buffers come from arena when given
+void sierpinskiTriangleCreateSimd(const SierpinskiTriangle& triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr, GenerationArena* arena = nullptr);
+void levyCCurveCreateSimd(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr, GenerationArena* arena = nullptr);
+
+// Write straight into vertex and colour arrays laid out the way GPU_Geometry expects them.
+// Both arrays need room for 3 * sierpinskiTriangleCount(iteration) or 2 * levySegmentCount(iteration)
+// vertices. Returns false if cancelled
+bool sierpinskiTriangleCreateSimd(const SierpinskiTriangle& triangle, int iteration, int totalIterations, glm::vec3* verts, glm::vec3* cols, SimdKernel kernel, const std::atomic<bool>* cancelled = nullptr, GenerationArena* arena = nullptr);
+bool levyCCurveCreateSimd(const LevyCCurve& line, int iteration, int totalIterations, glm::vec3* verts, glm::vec3* cols, SimdKernel kernel, const std::atomic<bool>* cancelled = nullptr, GenerationArena* arena = nullptr);
@@ -0,0 +1,124 @@
+#include "StreamingWorker.h"
+
+#include <utility>
+
+
+StreamingWorker::StreamingWorker(std::function<void()> onChunk, std::size_t chunkSize)
+	: onChunk(std::move(onChunk))
+	, chunkSize(chunkSize)
+	, thread(&StreamingWorker::run, this)
+{}
+
+
+StreamingWorker::~StreamingWorker() {
+	stop();
+}
+
+
+void StreamingWorker::request(const FractalRequest& newRequest) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending = newRequest;
+		hasPending = true;
+
+		// Whatever is running or waiting to be acquired now is stale
+		if (isRunning) {
+			cancelled = true;
+		}
+		dropReady();
+	}
+	wake.notify_all();
+}
+
+
+bool StreamingWorker::acquire(VertexChunk& chunk) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (ready.empty()) {
+			return false;
+		}
+		std::swap(chunk, ready.front());
+		ready.front().vertices.clear();
+		spare.push_back(std::move(ready.front().vertices));
+		ready.pop_front();
+	}
+	wake.notify_all(); // There is room for another chunk
+	return true;
+}
+
+
+void StreamingWorker::stop() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (stopping) {
+			return;
+		}
+		stopping = true;
+		cancelled = true;
+	}
+	wake.notify_all();
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+
+void StreamingWorker::run() {
+	while (true) {
+		FractalRequest job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return hasPending || stopping; });
+			if (stopping) {
+				return;
+			}
+			job = pending;
+			hasPending = false;
+			isRunning = true;
+			cancelled = false;
+		}
+
+		std::size_t firstVertex = 0;
+		VertexChunks chunks{ chunkSize, [&](std::vector<Vertex>& vertices) {
+			std::size_t count = vertices.size();
+			handOver(job, firstVertex, vertices);
+			firstVertex += count;
+		} };
+		generateFractal(job, chunks, &cancelled);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		isRunning = false;
+	}
+}
+
+
+void StreamingWorker::handOver(const FractalRequest& job, std::size_t firstVertex, std::vector<Vertex>& vertices) {
+	{
+		// Wait for the render loop to make room, unless the job gets cancelled meanwhile
+		std::unique_lock<std::mutex> lock(mutex);
+		wake.wait(lock, [this] { return ready.size() < MAX_READY_CHUNKS || cancelled; });
+		if (cancelled) {
+			return;
+		}
+
+		VertexChunk chunk;
+		chunk.request = job;
+		chunk.firstVertex = firstVertex;
+		chunk.vertices.swap(vertices);
+		if (!spare.empty()) {
+			vertices.swap(spare.back()); // Generate the next chunk into an old one
+			spare.pop_back();
+		}
+		ready.push_back(std::move(chunk));
+	}
+	onChunk();
+}
+
+
+void StreamingWorker::dropReady() {
+	for (VertexChunk& chunk : ready) {
+		chunk.vertices.clear();
+		spare.push_back(std::move(chunk.vertices));
+	}
+	ready.clear();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a background thread that generates fractal geometry in
+// fixed size chunks, so the render loop can upload and draw the first part of a
+// figure while the rest is still being generated
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Vertices per chunk. Big enough that a chunk is worth a glBufferSubData, small enough that the
+// first one arrives almost immediately
+constexpr std::size_t STREAM_CHUNK_VERTICES = 64 * 1024;
+
+// Most finished chunks waiting for the render loop. The worker waits once there are this many, so
+// a slow upload keeps memory use bounded instead of queueing the whole figure
+constexpr std::size_t MAX_READY_CHUNKS = 4;
+
+
+// A run of interleaved vertices of one figure, in generation order
+struct VertexChunk {
+	FractalRequest request;
+	std::size_t firstVertex = 0; // Position of vertices[0] in the whole figure
+	std::vector<Vertex> vertices;
+};
+
+
+// Generates fractals on a worker thread, handing them over as a stream of chunks.
+//
+// Only the most recent request is streamed. A new request cancels the running one and drops
+// its chunks that have not been acquired yet. The vectors of acquired chunks are handed back
+// to the worker to fill again, so streaming does not allocate once it has warmed up.
+class StreamingWorker {
+
+public:
+	// onChunk is called from the worker thread whenever a new chunk is ready.
+	// It should only do thread safe things, such as glfwPostEmptyEvent()
+	StreamingWorker(std::function<void()> onChunk, std::size_t chunkSize = STREAM_CHUNK_VERTICES);
+	~StreamingWorker();
+
+	// Disallow copying and moving, the thread holds a pointer to this
+	StreamingWorker(const StreamingWorker&) = delete;
+	StreamingWorker operator=(const StreamingWorker&) = delete;
+
+	// Public interface
+	void request(const FractalRequest& newRequest);
+
+	// Swaps the oldest ready chunk into chunk, whose vector is kept for the worker to reuse.
+	// Returns false if no chunk is ready
+	bool acquire(VertexChunk& chunk);
+
+	// Stops and joins the thread. Called by the destructor if not done earlier
+	void stop();
+
+private:
+	std::function<void()> onChunk;
+	std::size_t chunkSize;
+
+	std::mutex mutex;
+	std::condition_variable wake; // Requests, stopping and room for more chunks
+	FractalRequest pending;
+	bool hasPending = false;
+	bool stopping = false;
+	bool isRunning = false;
+	std::atomic<bool> cancelled{ false };
+
+	std::deque<VertexChunk> ready;
+	std::vector<std::vector<Vertex>> spare; // Emptied vectors, capacity kept
+
+	std::thread thread;
+
+	void run();
+	void handOver(const FractalRequest& job, std::size_t firstVertex, std::vector<Vertex>& vertices);
+	void dropReady(); // Needs the mutex
+};
@@ -0,0 +1,155 @@
+#include "StripFractals.h"
+
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+
+	/*
+	* Adds the points after line.A to the curve, in order
+	*
+	* @param line	Line from previous iteration
+	* @param iteration	Number of iterations left to generate
+	* @param totalIterations	Number of iterations to be generated in total
+	* @param cpuGeom	Collection of vectors for geometry
+	* @param cancelled	Optional flag, generation stops early once it is set
+	*
+	*/
+	void addLevyPoints(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+		if (isCancelled(cancelled)) {
+			return;
+		}
+
+		if (iteration > 0) {
+			for (const LevyCCurve& child : line.subdivide(iteration, totalIterations)) {
+				addLevyPoints(child, iteration - 1, totalIterations, cpuGeom, cancelled);
+			}
+		}
+		else {
+			// A is the previous line's B
+			cpuGeom.verts.push_back(line.B);
+			cpuGeom.cols.push_back(line.colourB);
+		}
+	}
+
+
+	// A path still to be written: branch and the top children after it, starting at vertex start
+	struct TreePath {
+		Tree branch;
+		int iteration;
+		int iterationCounter;
+		GLuint start;
+	};
+
+	template <typename Index>
+	void createTreeStrips(const Tree& branch, int iteration, int iterationCounter, std::vector<Vertex>& vertices, std::vector<Index>& indices, const std::atomic<bool>* cancelled) {
+		const Index restart = std::numeric_limits<Index>::max();
+
+		std::vector<TreePath> pending;
+		vertices.push_back({ branch.base, branch.colour });
+		pending.push_back({ branch, iteration, iterationCounter, 0 });
+
+		while (!pending.empty()) {
+			if (isCancelled(cancelled)) {
+				return;
+			}
+			TreePath path = pending.back();
+			pending.pop_back();
+
+			if (!indices.empty()) {
+				indices.push_back(restart);
+			}
+			indices.push_back(Index(path.start));
+
+			// Follow the top children to the end, leaving the left and right children for later
+			while (true) {
+				GLuint tip = GLuint(vertices.size());
+				vertices.push_back({ path.branch.top, path.branch.colour });
+				indices.push_back(Index(tip));
+
+				if (path.iteration == 0) {
+					break;
+				}
+				path.iterationCounter++;
+				std::array<Tree, 3> children = path.branch.grow(path.iterationCounter);
+
+				// Left and right both start at the middle of this branch
+				GLuint middle = GLuint(vertices.size());
+				vertices.push_back({ children[1].base, children[1].colour });
+				pending.push_back({ children[2], path.iteration - 1, path.iterationCounter, middle });
+				pending.push_back({ children[1], path.iteration - 1, path.iterationCounter, middle });
+
+				path.branch = children[0];
+				path.iteration--;
+			}
+		}
+	}
+}
+
+
+std::size_t levyStripVertexCount(int iteration) {
+	return levySegmentCount(iteration) + 1;
+}
+
+
+std::size_t treeStripVertexCount(int iteration) {
+	std::size_t middles = (iteration > 0) ? treeBranchCount(iteration - 1) : 0;
+	return treeBranchCount(iteration) + middles + 1;
+}
+
+
+/*
+* Creates the points of the Levy C Curve in order
+*
+* @param line	Initial line
+* @param iteration	Number of iterations to generate
+* @param totalIterations	Number of iterations to be generated in total
+* @param cpuGeom	Collection of vectors for geometry
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+void levyCCurveCreateStrip(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	checkFractalDepth(iteration);
+	cpuGeom.verts.clear();
+	cpuGeom.cols.clear();
+	cpuGeom.verts.reserve(levyStripVertexCount(iteration));
+	cpuGeom.cols.reserve(levyStripVertexCount(iteration));
+
+	cpuGeom.verts.push_back(line.A);
+	cpuGeom.cols.push_back(line.colourA);
+	addLevyPoints(line, iteration, totalIterations, cpuGeom, cancelled);
+}
+
+
+/*
+* Creates the paths of the Tree scene
+*
+* @param branch		Tree trunk
+* @param iteration	Number of iterations to generate
+* @param iterationCounter	tracks number of iterations completed to detect when to start creating leaves
+* @param cpuGeom	Collection of vectors for geometry
+* @param cancelled	Optional flag, generation stops early once it is set
+*
+*/
+void treeCreateStrips(const Tree& branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled) {
+	checkFractalDepth(iteration);
+	std::size_t vertexCount = treeStripVertexCount(iteration);
+
+	cpuGeom.verts.clear();
+	cpuGeom.cols.clear();
+	cpuGeom.vertices.clear();
+	cpuGeom.vertices.reserve(vertexCount);
+	cpuGeom.indices.clear();
+	cpuGeom.shortIndices.clear();
+
+	// The largest index is kept free for the restart index
+	if (vertexCount < std::numeric_limits<GLushort>::max()) {
+		createTreeStrips(branch, iteration, iterationCounter, cpuGeom.vertices, cpuGeom.shortIndices, cancelled);
+	}
+	else {
+		createTreeStrips(branch, iteration, iterationCounter, cpuGeom.vertices, cpuGeom.indices, cancelled);
+	}
+}
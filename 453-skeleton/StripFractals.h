@@ -0,0 +1,38 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains generators that write the line scenes as connected paths
+// instead of separate lines.
+//
+// The Levy C Curve is a single path, and neighbouring lines share their end
+// point with the same colour, so it becomes one GL_LINE_STRIP with every point
+// stored once. The output is the same, byte for byte, as the recursive
+// generator's points.
+//
+// The tree is split into paths that follow each branch on into its top child.
+// The left and right children start new paths at the middle of their parent,
+// so the paths are listed in an index buffer, separated by the restart index
+// (see GPU_IndexedGeometry). Neighbouring branches can have different colours,
+// so the tree is meant to be drawn with flat shading. Every line ends at the tip
+// of its branch, which is its provoking vertex and carries its colour.
+//------------------------------------------------------------------------------
+
+#include "Fractals.h"
+#include "Geometry.h"
+
+#include <atomic>
+#include <cstddef>
+
+
+// Number of points of the paths
+std::size_t levyStripVertexCount(int iteration); // 2^n + 1
+std::size_t treeStripVertexCount(int iteration); // Every tip, every middle and the base of the trunk
+
+// Replace the contents of cpuGeom with the points of the curve, in verts and cols.
+// Throws std::runtime_error if iteration is above MAX_FRACTAL_DEPTH
+void levyCCurveCreateStrip(const LevyCCurve& line, int iteration, int totalIterations, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
+
+// Replace the contents of cpuGeom with the points of the paths (in vertices) and the paths
+// (in shortIndices when they fit, otherwise in indices).
+// Throws std::runtime_error if iteration is above MAX_FRACTAL_DEPTH
+void treeCreateStrips(const Tree& branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom, const std::atomic<bool>* cancelled = nullptr);
@@ -0,0 +1,151 @@
+#include "TaskPool.h"
+
+#include <utility>
+
+
+namespace {
+	// Index of the pool worker running on this thread, -1 for any other thread
+	thread_local int workerIndex = -1;
+	thread_local const TaskPool* workerPool = nullptr;
+}
+
+
+TaskPool::TaskPool(unsigned int threadCount) {
+	if (threadCount == 0) {
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = (hardwareThreads > 1) ? hardwareThreads - 1 : 1;
+	}
+
+	for (unsigned int i = 0; i < threadCount; i++) {
+		queues.push_back(std::make_unique<WorkQueue>());
+	}
+	for (unsigned int i = 0; i < threadCount; i++) {
+		workers.emplace_back(&TaskPool::run, this, int(i));
+	}
+}
+
+
+TaskPool::~TaskPool() {
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+
+void TaskPool::submit(std::function<void()> task) {
+	// Workers keep their own tasks local, other threads spread theirs round robin
+	int index = (workerPool == this) ? workerIndex : int(nextQueue++ % queues.size());
+	{
+		std::lock_guard<std::mutex> lock(queues[index]->mutex);
+		queues[index]->tasks.push_back(std::move(task));
+	}
+	{
+		// Taking the lock orders the increment with a worker deciding to go to sleep
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		queuedTasks++;
+	}
+	wake.notify_one();
+}
+
+
+bool TaskPool::popLocal(int index, std::function<void()>& task) {
+	WorkQueue& queue = *queues[index];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.tasks.empty()) {
+		return false;
+	}
+	task = std::move(queue.tasks.back());
+	queue.tasks.pop_back();
+	queuedTasks--;
+	return true;
+}
+
+
+bool TaskPool::steal(int thief, std::function<void()>& task) {
+	int count = int(queues.size());
+	for (int offset = 1; offset <= count; offset++) {
+		WorkQueue& queue = *queues[(thief + offset) % count];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.tasks.empty()) {
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			queuedTasks--;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+bool TaskPool::runPendingTask() {
+	std::function<void()> task;
+	bool found = (workerPool == this) ? (popLocal(workerIndex, task) || steal(workerIndex, task)) : steal(0, task);
+	if (found) {
+		task();
+	}
+	return found;
+}
+
+
+void TaskPool::waitForTask(const std::function<bool()>& done) {
+	std::unique_lock<std::mutex> lock(sleepMutex);
+	wake.wait(lock, [&] { return stopping || queuedTasks > 0 || done(); });
+}
+
+
+void TaskPool::notifyWaiting() {
+	{
+		// Taking the lock orders the change with a waiter deciding to go to sleep
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	wake.notify_all();
+}
+
+
+void TaskPool::run(int index) {
+	workerIndex = index;
+	workerPool = this;
+
+	while (true) {
+		std::function<void()> task;
+		if (popLocal(index, task) || steal(index, task)) {
+			task();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wake.wait(lock, [this] { return stopping || queuedTasks > 0; });
+		if (stopping) {
+			return;
+		}
+	}
+}
+
+
+//------------------------------------------------------------------------------
+
+
+void TaskGroup::run(std::function<void()> task) {
+	remaining++;
+	pool.submit([this, &pool = pool, task = std::move(task)]() {
+		task();
+		// The group may be gone as soon as remaining reaches 0, so only the pool is used after it
+		if (--remaining == 0) {
+			pool.notifyWaiting();
+		}
+	});
+}
+
+
+void TaskGroup::wait() {
+	while (remaining > 0) {
+		if (!pool.runPendingTask()) {
+			pool.waitForTask([this] { return remaining == 0; });
+		}
+	}
+}
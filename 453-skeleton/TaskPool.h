@@ -0,0 +1,90 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// This file contains a small work-stealing thread pool for splitting recursive
+// work (such as fractal subtrees) across all cores
+//------------------------------------------------------------------------------
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Every worker thread owns a deque of tasks. A worker pushes and pops new tasks at the
+// back of its own deque (newest first, which keeps recursive work depth first and cache
+// friendly) and, when it runs dry, steals the oldest task from the front of another
+// worker's deque (which tends to be the largest remaining piece of work).
+class TaskPool {
+
+public:
+	// threadCount of 0 picks one worker per hardware thread (minus the caller's own thread)
+	explicit TaskPool(unsigned int threadCount = 0);
+	~TaskPool();
+
+	// Disallow copying and moving, the workers hold a pointer to this
+	TaskPool(const TaskPool&) = delete;
+	TaskPool operator=(const TaskPool&) = delete;
+
+	// Public interface
+	void submit(std::function<void()> task);
+
+	// Runs one queued task on the calling thread if there is any.
+	// Lets threads that wait on tasks help out instead of blocking
+	bool runPendingTask();
+
+	// Sleeps until a task is queued or done() returns true. done is checked under the lock
+	// of the pool, so whatever makes it true has to call notifyWaiting() afterwards
+	void waitForTask(const std::function<bool()>& done);
+	void notifyWaiting();
+
+	unsigned int threadCount() const { return unsigned(workers.size()); }
+
+private:
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+	std::vector<std::thread> workers;
+
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	std::atomic<int> queuedTasks{ 0 };
+	std::atomic<unsigned int> nextQueue{ 0 };
+	bool stopping = false;
+
+	bool popLocal(int index, std::function<void()>& task);
+	bool steal(int thief, std::function<void()>& task);
+	void run(int index);
+};
+
+
+// Tracks a set of tasks so a caller can wait for all of them. Tasks may add more tasks to
+// the same group while running. Waiting threads execute queued tasks while they wait, and
+// sleep while there are none.
+class TaskGroup {
+
+public:
+	explicit TaskGroup(TaskPool& pool) : pool(pool) {}
+	~TaskGroup() { wait(); }
+
+	// Disallow copying and moving, queued tasks hold a pointer to this
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup operator=(const TaskGroup&) = delete;
+
+	// Public interface
+	void run(std::function<void()> task);
+	void wait();
+
+	TaskPool& getPool() const { return pool; }
+
+private:
+	TaskPool& pool;
+	std::atomic<int> remaining{ 0 };
+};
@@ -1,18 +1,78 @@
 #include "VertexBuffer.h"
 
+#include <stdexcept>
 #include <utility>
 
 
-VertexBuffer::VertexBuffer(GLuint index, GLint size, GLenum dataType)
+VertexBuffer::VertexBuffer(GLuint index, GLint size, GLenum dataType, GLboolean normalized)
 	: bufferID{}
 {
+	setAttribute(index, size, dataType, 0, 0, normalized);
+}
+
+
+VertexBuffer::VertexBuffer()
+	: bufferID{}
+{}
+
+
+void VertexBuffer::setAttribute(GLuint index, GLint size, GLenum dataType, GLsizei stride, std::size_t offset, GLboolean normalized) {
 	bind();
-	glVertexAttribPointer(index, size, dataType, GL_FALSE, 0, (void*)0);
+	glVertexAttribPointer(index, size, dataType, normalized, stride, (void*)offset);
 	glEnableVertexAttribArray(index);
 }
 
 
+void VertexBuffer::setIntegerAttribute(GLuint index, GLint size, GLenum dataType, GLsizei stride, std::size_t offset) {
+	bind();
+	glVertexAttribIPointer(index, size, dataType, stride, (void*)offset);
+	glEnableVertexAttribArray(index);
+}
+
+
+void VertexBuffer::setInstanceAttribute(GLuint index, GLint size, GLenum dataType, GLsizei stride, std::size_t offset, GLboolean normalized) {
+	setAttribute(index, size, dataType, stride, offset, normalized);
+	glVertexAttribDivisor(index, 1);
+}
+
+
 void VertexBuffer::uploadData(GLsizeiptr size, const void* data, GLenum usage) {
 	bind();
 	glBufferData(GL_ARRAY_BUFFER, size, data, usage);
 }
+
+
+void VertexBuffer::updateData(GLintptr offset, GLsizeiptr size, const void* data) {
+	bind();
+	glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+}
+
+
+void VertexBuffer::downloadData(GLintptr offset, GLsizeiptr size, void* data) const {
+	bind();
+	glGetBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+}
+
+
+void* VertexBuffer::map(GLintptr offset, GLsizeiptr size, GLbitfield access) {
+	bind();
+	void* data = glMapBufferRange(GL_ARRAY_BUFFER, offset, size, access);
+	if (data == nullptr) {
+		throw std::runtime_error("Failed to map the vertex buffer.");
+	}
+	return data;
+}
+
+
+bool VertexBuffer::unmap() {
+	bind();
+	return glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+}
+
+
+#ifdef USE_OPENGL_4_6
+void VertexBuffer::allocateStorage(GLsizeiptr size, GLbitfield flags) {
+	bind();
+	glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+}
+#endif
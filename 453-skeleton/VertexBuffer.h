@@ -4,11 +4,14 @@
 
 #include <glad/glad.h>
 
+#include <cstddef>
+
 
 class VertexBuffer {
 
 public:
-	VertexBuffer(GLuint index, GLint size, GLenum dataType);
+	VertexBuffer(GLuint index, GLint size, GLenum dataType, GLboolean normalized = GL_FALSE);
+	VertexBuffer(); // No attributes yet, add them with setAttribute
 
 	// Because we're using the VertexBufferHandle to do RAII for the buffer for us
 	// and our other types are trivial or provide their own RAII
@@ -19,7 +22,37 @@ public:
 
 	// Public interface
 	void bind() const { glBindBuffer(GL_ARRAY_BUFFER, bufferID); }
+	void bind(GLenum target) const { glBindBuffer(target, bufferID); }
 	void uploadData(GLsizeiptr size, const void* data, GLenum usage);
+	void updateData(GLintptr offset, GLsizeiptr size, const void* data); // Within what uploadData allocated
+	void downloadData(GLintptr offset, GLsizeiptr size, void* data) const; // Waits for the GPU to finish writing it
+
+	// Maps size bytes starting at offset with glMapBufferRange, for the CPU to write to directly.
+	// Unless access has GL_MAP_PERSISTENT_BIT, unmap before drawing from the buffer.
+	// Throws std::runtime_error if the driver cannot map it
+	void* map(GLintptr offset, GLsizeiptr size, GLbitfield access);
+	bool unmap(); // Returns false if the contents got lost while mapped (and need writing again)
+#ifdef USE_OPENGL_4_6
+	// Allocates size bytes of immutable storage (glBufferStorage) instead of uploadData. Storage
+	// allocated with GL_MAP_PERSISTENT_BIT can stay mapped while the GPU draws from it.
+	// Needs an OpenGL 4.4 context (GLAD_GL_VERSION_4_4)
+	void allocateStorage(GLsizeiptr size, GLbitfield flags);
+#endif
+
+	// Binds size bytes starting at offset to binding index of an indexed target
+	// (GL_TRANSFORM_FEEDBACK_BUFFER, or GL_SHADER_STORAGE_BUFFER for compute shaders)
+	void bindRange(GLenum target, GLuint index, GLintptr offset, GLsizeiptr size) const { glBindBufferRange(target, index, bufferID, offset, size); }
+
+	// Sources attribute index from this buffer, stride bytes apart starting at offset.
+	// Several attributes can share one buffer this way (interleaved vertices).
+	// Integer data types are mapped to [-1, 1] or [0, 1] when normalized is GL_TRUE
+	void setAttribute(GLuint index, GLint size, GLenum dataType, GLsizei stride, std::size_t offset, GLboolean normalized = GL_FALSE);
+
+	// Same, but integer data types reach the shader as integers (ivec or uvec attributes)
+	void setIntegerAttribute(GLuint index, GLint size, GLenum dataType, GLsizei stride, std::size_t offset);
+
+	// Same as setAttribute, but the attribute advances once per instance instead of once per vertex
+	void setInstanceAttribute(GLuint index, GLint size, GLenum dataType, GLsizei stride, std::size_t offset, GLboolean normalized = GL_FALSE);
 
 private:
 	VertexBufferHandle bufferID;
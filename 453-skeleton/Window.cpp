@@ -38,6 +38,12 @@ void Window::windowSizeMetaCallback(GLFWwindow* window, int width, int height) {
 	callbacks->windowSizeCallback(width, height);
 }
 
+
+void Window::windowRefreshMetaCallback(GLFWwindow* window) {
+	CallbackInterface* callbacks = static_cast<CallbackInterface*>(glfwGetWindowUserPointer(window));
+	callbacks->windowRefreshCallback();
+}
+
 // ----------------------
 // non-static definitions
 // ----------------------
@@ -50,8 +56,13 @@ Window::Window(
 	, callbacks(callbacks)
 {
 	// specify OpenGL version
+#ifdef USE_OPENGL_4_6
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3); // Enough for compute shaders, newer contexts also have glBufferStorage
+#else
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+#endif
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE); // needed for mac?
 	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
@@ -93,6 +104,7 @@ void Window::connectCallbacks() {
 	glfwSetCursorPosCallback(window.get(), cursorPosMetaCallback);
 	glfwSetScrollCallback(window.get(), scrollMetaCallback);
 	glfwSetWindowSizeCallback(window.get(), windowSizeMetaCallback);
+	glfwSetWindowRefreshCallback(window.get(), windowRefreshMetaCallback);
 }
 
 
@@ -1,87 +1,44 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
-#include <iostream>
+#include <argh.h>
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Camera.h"
+#include "ColourMap.h"
+#include "ComputeFractals.h"
+#include "FeedbackFractals.h"
+#include "Fractals.h"
+#include "GenerationWorker.h"
+#include "GeometryCache.h"
 #include "Geometry.h"
 #include "GLDebug.h"
 #include "Log.h"
+#include "ProceduralFractals.h"
 #include "ShaderProgram.h"
 #include "Shader.h"
+#include "StreamingWorker.h"
 #include "Window.h"
 #include "AssetPath.h"
 
 
-class SierpinskiTriangle {
-public:
-	// Triangle vertices
-	glm::vec3 A;
-	glm::vec3 B;
-	glm::vec3 C;
-
-	// Triangle colour
-	glm::vec3 colour;
-
-	// Triangle constructor
-	SierpinskiTriangle(glm::vec3 x, glm::vec3 y, glm::vec3 z, glm::vec3 newColour) {
-
-		A = x;
-		B = y;
-		C = z;
-
-		colour = newColour;
-
-	}
-};
-
-class LevyCCurve {
-public:
-	// Line verticles
-	glm::vec3 A;
-	glm::vec3 B;
-
-	// Colours
-	glm::vec3 colourA;
-	glm::vec3 colourB;
-
-	// Line constructor for C Curve
-	LevyCCurve(glm::vec3 x, glm::vec3 y, glm::vec3 colourLeft, glm::vec3 colourRight) {
-		A = x;
-		B = y;
-
-		colourA = colourLeft;
-		colourB = colourRight;
-	}
-};
-
-class Tree {
-public:
-
-	glm::vec3 base; // base of branch/leaf
-	glm::vec3 top; // tip of branch/leaf
-
-	glm::vec3 colour;
-
-	// Tree branch/leaf constructor
-	Tree(glm::vec3 base, glm::vec3 top, glm::vec3 colour) {
-		this->base = base;
-		this->top = top;
-
-		this->colour = colour;
-	}
-};
-
-// Function prototypes
-void sierpinskiTriangleCreate(SierpinskiTriangle triangle, int iteration, int totalIterations, CPU_Geometry& cpuGeom);
-void levyCCurveCreate(LevyCCurve curve, int iteration, int totalIterations, CPU_Geometry& cpuGeom);
-void treeCreate(Tree branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom);
 
 
 // Callbacks
 class MyCallbacks : public CallbackInterface {
 
 public:
-	MyCallbacks(int& iteration, int& sceneNumber, int& maxIterations) : iteration(iteration), sceneNumber(sceneNumber), maxIterations(maxIterations) {}
+	// camera is only moved with the mouse when it is given
+	MyCallbacks(int& iteration, int& sceneNumber, int& maxIterations, Camera* camera, glm::ivec2 windowSize)
+		: iteration(iteration), sceneNumber(sceneNumber), maxIterations(maxIterations), camera(camera), windowSize(windowSize) {}
 
 	// Increase and decrease scene and iteratios with arrow keys
 	virtual void keyCallback(int key, int scancode, int action, int mods) {
@@ -91,6 +48,7 @@ public:
 			
 			if (iteration < maxIterations) {
 				iteration++;
+				stateChanged();
 			}
 		}
 
@@ -98,345 +56,794 @@ public:
 		if (key == GLFW_KEY_DOWN && action == GLFW_PRESS) {
 			if (iteration > 0) {
 				iteration--;
+				stateChanged();
 			}
 		}
 		// Right arrow key switches to next scene
 		if (key == GLFW_KEY_RIGHT && action == GLFW_PRESS) {
-			if (sceneNumber < 2) {
+			if (sceneNumber < SCENE_COUNT - 1) {
 				sceneNumber++;
+				stateChanged();
 			}		
 		}
 		// Left arrow key switches to previous scene
 		if (key == GLFW_KEY_LEFT && action == GLFW_PRESS) {
 			if (sceneNumber > 0) {
 				sceneNumber--;
+				stateChanged();
 			}
 		}
+		// R resets the camera
+		if (key == GLFW_KEY_R && action == GLFW_PRESS && camera) {
+			camera->reset();
+			cameraMoved();
+		}
 	}
 
 	// Increase and decrease scene and iterations with mouse
 	virtual void mouseButtonCallback(int button, int action, int mods) {
 
+		// With the camera, dragging with the left button pans instead
+		if (camera) {
+			if (button == GLFW_MOUSE_BUTTON_LEFT) {
+				dragging = (action == GLFW_PRESS);
+			}
+			return;
+		}
+
 		// Left click switches to next scene
 		if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
-			if (sceneNumber < 2) {
+			if (sceneNumber < SCENE_COUNT - 1) {
 				sceneNumber++;
+				stateChanged();
 			}
 		}
 		// Right click switches to previous scene
 		if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS) {
 			if (sceneNumber > 0) {
 				sceneNumber--;
+				stateChanged();
 			}
 		}	
 	}
 
 	// Controll iteration number using scroll (mouse wheel)
+	// Each notch only bumps the state version, the render loop turns a whole burst into one request
 	virtual void scrollCallback(double xoffset, double yoffset) {
+
+		// With the camera, scrolling zooms in and out around the cursor instead
+		if (camera) {
+			camera->zoomAt(cursor, std::pow(1.25, yoffset), windowSize);
+			cameraMoved();
+			return;
+		}
 		
 		// Scroll up to increase iteration
 		if (yoffset > 0 && iteration < maxIterations) {
 			iteration++;
+			stateChanged();
 		}
 
 		// Scroll down to decrease iteration
 		if (yoffset < 0 && iteration > 0) {
 			iteration--;
+			stateChanged();
+		}
+	}
+
+	virtual void cursorPosCallback(double xpos, double ypos) {
+		glm::dvec2 previous = cursor;
+		cursor = glm::dvec2(xpos, ypos);
+		if (camera && dragging) {
+			camera->pan(previous, cursor, windowSize);
+			cameraMoved();
+		}
+	}
+
+	// Resizing or exposing the window only needs a redraw of the current geometry,
+	// unless the camera has to generate what it now shows
+	virtual void windowSizeCallback(int width, int height) {
+		CallbackInterface::windowSizeCallback(width, height);
+		windowSize = glm::ivec2(width, height);
+		damaged = true;
+		if (camera) {
+			stateChanged();
 		}
 	}
 
+	virtual void windowRefreshCallback() {
+		damaged = true;
+	}
+
+	void markDamaged() {
+		damaged = true;
+	}
+
+	glm::ivec2 getWindowSize() const { return windowSize; }
+
+	// Incremented every time the scene, iteration or camera changes, so the render loop
+	// can tell when its geometry is out of date
+	unsigned int getStateVersion() const { return stateVersion; }
+
+	// Returns true (once) if the window needs to be redrawn
+	bool consumeDamage() {
+		bool wasDamaged = damaged;
+		damaged = false;
+		return wasDamaged;
+	}
+
 private:
 	int& iteration;
 	int& sceneNumber;
 	int& maxIterations;
+	Camera* camera;
+	glm::ivec2 windowSize;
+	glm::dvec2 cursor = glm::dvec2(0.0);
+	bool dragging = false;
 
-};
+	unsigned int stateVersion = 0;
+	bool damaged = true; // Nothing has been drawn yet
 
+	void stateChanged() {
+		stateVersion++;
+	}
 
+	// The current geometry is redrawn where the camera moved it straight away, the geometry of
+	// the new view follows once it has been generated
+	void cameraMoved() {
+		stateChanged();
+		damaged = true;
+	}
 
-int main() {
+};
 
-	Log::debug("Starting main");
 
-	// WINDOW
-	glfwInit();//MUST call this first to set up environment (There is a terminate pair after the loop)
-	Window window(800, 800, "CPSC 453 Assignment 1: Fractals"); // Can set callbacks at construction if desired
 
-	//GLDebug::enable(); // ON Submission you may comments this out to avoid unnecessary prints to the console
+// Which GPU geometry (and shader) a generated result is drawn with
+enum class DrawPath {
+	Arrays, // GPU_Geometry
+	Instanced, // GPU_InstancedGeometry
+	Hierarchy, // GPU_HierarchyGeometry
+	Indexed, // GPU_IndexedGeometry
+	Coded, // GPU_CodedGeometry
+	Procedural, // GPU_ProceduralGeometry, nothing generated
+	Pixel, // Full screen triangle, the figure is worked out per fragment
+	Indirect, // GPU_Geometry, with the vertex count the ComputeGenerator wrote
+	Mapped, // GPU_MappedGeometry, written straight into by the iterative generator
+	Streamed, // GPU_Geometry, filled in chunk by chunk by the StreamingWorker
+	Pyramid, // GPU_PyramidGeometry, one level of it
+	Cached // GPU_Geometry of a GeometryCache entry
+};
 
-	// SHADERS
-	ShaderProgram shader(
-		AssetPath::Instance()->Get("shaders/basic.vert"), 
-		AssetPath::Instance()->Get("shaders/basic.frag")
-	); // Render pipeline we will use (You can use more than one!)
 
-	// CALLBACKS
-	int iteration = 0;
-	int sceneNumber = 0;
-	int maxIterations;
-	
-	std::shared_ptr<MyCallbacks> Callback_ptr = std::make_shared<MyCallbacks>(iteration, sceneNumber, maxIterations); // Class To capture input events
-	window.setCallbacks(Callback_ptr); // Can also update callbacks to new ones as needed (create more than one instance)
+// The GPU resources each scene keeps to itself, built from its Scene entry, so switching back to a
+// scene whose vertices are still resident only changes what is bound
+struct SceneResources {
+	SceneResources(const Scene& scene, VertexLayout layout, bool procedural, bool pixel)
+		: shader(AssetPath::Instance()->Get(scene.vertexShader), AssetPath::Instance()->Get(scene.fragmentShader))
+		, gpuGeom(layout)
+		, pyramid(layout)
+	{
+		if (procedural && scene.proceduralShader != nullptr) {
+			proceduralShader.emplace(AssetPath::Instance()->Get(scene.proceduralShader), AssetPath::Instance()->Get("shaders/basic.frag"));
+		}
+		if (pixel && scene.pixelShader != nullptr) {
+			pixelShader.emplace(AssetPath::Instance()->Get("shaders/fullscreen.vert"), AssetPath::Instance()->Get(scene.pixelShader));
+		}
+	}
 
-	// GEOMETRY
-	CPU_Geometry cpuGeom; // Just a collection of vectors
-	GPU_Geometry gpuGeom; // Wrapper managing VAO and VBOs, in a TIGHTLY packed format
-	//https://www.khronos.org/opengl/wiki/Vertex_Specification_Best_Practices#Attribute_sizes
+	ShaderProgram shader; // Draws the plain vertices of the scene, whichever path made them
+	std::optional<ShaderProgram> proceduralShader; // Works out each vertex from its index, for --procedural
+	std::optional<ShaderProgram> pixelShader; // Works out whether each pixel is in the figure, for --pixel
+	GPU_Geometry gpuGeom; // Plain vertices of the last result shown of the scene
+	std::optional<FractalRequest> resident; // What gpuGeom holds, if it can be drawn again as it is
+	GLsizei vertexCount = 0; // Of gpuGeom
+	GPU_PyramidGeometry pyramid; // Every iteration of the scene, for --pyramid
+};
 
-	
-	// vertices (initial triangle)
-	glm::vec3 ver1(- 0.75f, -float(sqrt(27)) / 8, 0.f );
-	glm::vec3 ver2(0.75f, -float(sqrt(27)) / 8, 0.f);
-	glm::vec3 ver3(0.f, float(sqrt(27)) / 8, 0.f);
+// How the geometry a generator wrote is drawn
+DrawPath drawPathFor(const CPU_Geometry& cpuGeom) {
+	switch (cpuGeom.kind) {
+	case GeometryKind::Instances: return DrawPath::Instanced;
+	case GeometryKind::Hierarchy: return DrawPath::Hierarchy;
+	case GeometryKind::Indexed: return DrawPath::Indexed;
+	case GeometryKind::Coded: return DrawPath::Coded;
+	case GeometryKind::Levels: return DrawPath::Pyramid;
+	default: return DrawPath::Arrays;
+	}
+}
 
-	// Initial triangle colour
-	glm::vec3 colourInit(1.f, 0.7f, .5f );
 
-	SierpinskiTriangle triangle(ver1, ver2, ver3, colourInit);
+// The states one input away from request: the iteration either side, then the scene either side
+// (at the same iteration, as far as that scene goes)
+std::vector<FractalRequest> neighbouringRequests(const FractalRequest& request, int maxIterations, bool cameraEnabled) {
+	std::vector<FractalRequest> neighbours;
+	if (request.iteration < maxIterations) {
+		neighbours.push_back({ request.sceneNumber, request.iteration + 1, request.view });
+	}
+	if (request.iteration > 0) {
+		neighbours.push_back({ request.sceneNumber, request.iteration - 1, request.view });
+	}
+	for (int scene : { request.sceneNumber + 1, request.sceneNumber - 1 }) {
+		if (scene >= 0 && scene < SCENE_COUNT) {
+			int sceneMaxIterations = cameraEnabled ? MAX_FRACTAL_DEPTH : fractalMaxIterations(scene);
+			neighbours.push_back({ scene, std::min(request.iteration, sceneMaxIterations), request.view });
+		}
+	}
+	return neighbours;
+}
 
-	// vertices (initial line of Levy C Curve)
-	glm::vec3 ver4(- 0.5f, -0.3f, 0.f);
-	glm::vec3 ver5( 0.5f, -0.3f, 0.f );
 
-	glm::vec3 colourLeft( 0.f, 1.f, 0.f );
-	glm::vec3 colourRight(0.f, 0.f, 1.f );
-	LevyCCurve line(ver4, ver5, colourLeft, colourRight);
 
-	// Initial tree trunk
-	glm::vec3 trunkBase(0.f, -0.85f, 0.f);
-	glm::vec3 trunkTop(0.f, 0.f, 0.f);
+int main(int argc, char** argv) {
 
-	glm::vec3 branchColour(.25f, .18f, .1f);
-	Tree tree(trunkBase, trunkTop, branchColour);
+	Log::debug("Starting main");
 
+	// COMMAND LINE
+	argh::parser cmdl(argc, argv, argh::parser::PREFER_PARAM_FOR_UNREG_OPTION);
 
-	// RENDER LOOP
-	while (!window.shouldClose()) {
-		glfwPollEvents(); // Propagate events to the callback class
+	GeneratorType generatorType = GeneratorType::Parallel;
+	std::string generatorName = cmdl("generator", "parallel").str();
+	if (!parseGeneratorType(generatorName, generatorType)) {
+		Log::warn("Unknown generator '{}', using parallel", generatorName);
+	}
 
-		shader.use(); // Use "this" shader to render
-		gpuGeom.bind(); // USe "this" VAO (Geometry) on render call
-		cpuGeom.verts.clear();
-		cpuGeom.cols.clear();
+	OutputFormat format;
 
-		// Scene 0: Sierpinski Triangle
-		if (sceneNumber == 0) {
-			maxIterations = 10;
-			// Prevent from generating a higher number of iterations than allowed
-			if (iteration > maxIterations) {
-				iteration = maxIterations;
-			}
+	// Position and colour interleaved in one VBO, instead of one VBO each, optionally packed
+	if (cmdl["packed"]) {
+		format.layout = VertexLayout::Packed;
+	}
+	else if (cmdl["interleaved"]) {
+		format.layout = VertexLayout::Interleaved;
+	}
 
-			int totalIterations = iteration;
-			sierpinskiTriangleCreate(triangle, iteration, totalIterations, cpuGeom);
-			gpuGeom.setVerts(cpuGeom.verts); // Upload vertex position geometry to VBO
-			gpuGeom.setCols(cpuGeom.cols); // Upload vertex colour attribute to VBO
+	// Draw the Sierpinski Triangle as instances of one triangle, or else as an indexed mesh
+	format.instanced = cmdl["instanced"];
+	format.mesh = cmdl["mesh"];
 
-			glEnable(GL_FRAMEBUFFER_SRGB); // Expect Colour to be encoded in sRGB standard (as opposed to RGB) 
-			// https://www.viewsonic.com/library/creative-work/srgb-vs-adobe-rgb-which-one-to-use/
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Clear render screen (all zero) and depth (all max depth)
-			glDrawArrays(GL_TRIANGLES, 0, cpuGeom.verts.size()); // Render primitives
-			glDisable(GL_FRAMEBUFFER_SRGB); // disable sRGB for things like imgui (if used)
+	// Draw the Levy C Curve and Tree by composing per level transforms on the GPU
+	format.hierarchical = cmdl["hierarchical"];
 
-		}
+	// Otherwise draw them as connected paths, storing shared points once
+	format.strips = cmdl["strips"];
 
-		// Scene 1: Levy C Curve
-		else if (sceneNumber == 1) {
-			maxIterations = 18;
-			// Prevent from generating a higher number of iterations than allowed
-			if (iteration > maxIterations) {
-				iteration = maxIterations;
-			}
-			int totalIterations = iteration * 2; // TNumber of iterations in one curve
-			levyCCurveCreate(line, iteration, totalIterations, cpuGeom);
-			gpuGeom.setVerts(cpuGeom.verts); // Upload vertex position geometry to VBO
-			gpuGeom.setCols(cpuGeom.cols); // Upload vertex colour attribute to VBO
-			
-			glEnable(GL_FRAMEBUFFER_SRGB); 
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); 
-			glDrawArrays(GL_LINES, 0, cpuGeom.verts.size()); 
-			glDisable(GL_FRAMEBUFFER_SRGB); 
-		}
-		
-		// Scene 3: Tree
-		else if (sceneNumber == 2) {
-			maxIterations = 10;
-			// Prevent from generating a higher number of iterations than allowed
-			if (iteration > maxIterations) {
-				iteration = maxIterations;
-			}
-			int iterationCounter = 0;
-			treeCreate(tree, iteration, iterationCounter, cpuGeom);
-			gpuGeom.setVerts(cpuGeom.verts); // Upload vertex position geometry to VBO
-			gpuGeom.setCols(cpuGeom.cols); // Upload vertex colour attribute to VBO
+	// Store a colour code per vertex and colour it on the GPU, optionally from a colour map
+	format.coded = cmdl["coded"];
+	std::string colourMapName = cmdl("colormap", "").str();
 
-			glEnable(GL_FRAMEBUFFER_SRGB); 
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); 
-			glDrawArrays(GL_LINES, 0, cpuGeom.verts.size()); 
-			glDisable(GL_FRAMEBUFFER_SRGB); 
-		}		
+	// Pan and zoom with the mouse, only generating what is on screen and no smaller than a pixel
+	bool cameraEnabled = cmdl["camera"];
+	format.culled = cameraEnabled;
+	if (cameraEnabled && format.layout == VertexLayout::Packed) {
+		Log::warn("Packed positions are too coarse for the views of the camera, using --interleaved instead");
+		format.layout = VertexLayout::Interleaved;
+	}
+	if (cameraEnabled && (format.instanced || format.mesh || format.hierarchical || format.strips || format.coded)) {
+		Log::warn("The camera only generates separate primitives, ignoring --instanced, --mesh, --hierarchical, --strips and --coded");
+		format.instanced = format.mesh = format.hierarchical = format.strips = format.coded = false;
+	}
 
-		window.swapBuffers(); //Swap the buffers while displaying the previous 	
+	// Keep every iteration of a scene on the GPU once it has been shown, so changing iteration is instant
+	format.pyramid = cmdl["pyramid"];
+	if (format.pyramid && cameraEnabled) {
+		Log::warn("The camera only generates what it shows, so iterations cannot be kept for --pyramid");
+		format.pyramid = false;
 	}
 
-	glfwTerminate(); // Clean up GLFW
-	return 0;
-}
+	// Keep up to this many MB of generated scenes, and generate the neighbouring states while idle. 0 turns it off
+	std::size_t cacheMegabytes = DEFAULT_CACHE_BYTES >> 20;
+	cmdl("cache-mb", cacheMegabytes) >> cacheMegabytes;
 
+	// Draw the Sierpinski Triangle and Levy C Curve entirely in the vertex shader
+	bool procedural = cmdl["procedural"];
 
-/*
-* Creates vertices and colours for Sierpinski Triangle and adds them to the vertex and colour vectors
-* 
-* @param triangle	Triangle from previous iteration
-* @param iteration	Number of iterations to generate
-* @param totalIterations	Number of iterations to be generated in total
-* @param cpuGeom	Collection of vectors for geometry
-* 
-*/
-void sierpinskiTriangleCreate(SierpinskiTriangle triangle, int iteration, int totalIterations, CPU_Geometry & cpuGeom) {
-	
-	if (iteration > 0) {
-		// New vertices from midpoins of triangle sides
-		glm::vec3 D(0.5f * (triangle.A + triangle.C));
-		glm::vec3 E(0.5f * (triangle.C + triangle.B));
-		glm::vec3 F(0.5f * (triangle.B + triangle.A));
-		
-		float increment = (static_cast<float>(iteration) / totalIterations) * 0.33f; // Colour incremented based on iterations
-		glm::vec3	leftColour = { triangle.colour.x, triangle.colour.y, triangle.colour.z + increment}; // increase blue
-		glm::vec3	rightColour = { triangle.colour.x, triangle.colour.y, triangle.colour.z - increment }; // decrease blue 
-		glm::vec3	topColour = { triangle.colour.x, triangle.colour.y - increment, triangle.colour.z}; // decrease green
-	
-		// Create new trianges using new vertices and vertices of previous triangles
-		SierpinskiTriangle topTriangle(D, E, triangle.C, topColour);
-		SierpinskiTriangle rightTriangle(triangle.A, F, D, rightColour);
-		SierpinskiTriangle leftTriangle(F, triangle.B, E, leftColour);
+	// Draw the Sierpinski Triangle per pixel, which allows far deeper iterations
+	bool pixel = cmdl["pixel"];
 
-		sierpinskiTriangleCreate(topTriangle, iteration - 1, totalIterations, cpuGeom);
-		sierpinskiTriangleCreate(leftTriangle, iteration - 1, totalIterations, cpuGeom);
-		sierpinskiTriangleCreate(rightTriangle, iteration - 1, totalIterations, cpuGeom);
+	// Generate every scene on the worker straight into mapped vertex buffers, instead of uploading it
+	bool mapped = cmdl["mapped"];
+	if (mapped && cmdl("generator") && generatorType != GeneratorType::Iterative) {
+		Log::warn("Only the iterative generator writes into mapped buffers, ignoring --generator {}", generatorName);
+	}
 
-		
+	// Or stream them from a worker in chunks, drawing each chunk as soon as it is uploaded
+	bool streaming = cmdl["streaming"];
+
+	// Subdivide every scene on the GPU with transform feedback, instead of on the worker
+	bool feedback = cmdl["feedback"];
+	if (feedback && format.layout == VertexLayout::Packed) {
+		Log::warn("Transform feedback cannot write packed vertices, generating on the worker instead");
+		feedback = false;
 	}
-	else {
-		// Add vertices to vertice vector
-		cpuGeom.verts.push_back(glm::vec3(triangle.A)); // Lower Left
-		cpuGeom.verts.push_back(glm::vec3(triangle.B)); // Lower Right
-		cpuGeom.verts.push_back(glm::vec3(triangle.C)); // Upper	
 
-		// Add colours to colour vector
-		cpuGeom.cols.push_back(glm::vec3(triangle.colour));
-		cpuGeom.cols.push_back(glm::vec3(triangle.colour));
-		cpuGeom.cols.push_back(glm::vec3(triangle.colour));
+	// Or with compute shaders, which needs the OpenGL 4.6 build
+	bool compute = cmdl["compute"];
+#ifdef USE_OPENGL_4_6
+	if (compute && format.layout == VertexLayout::Packed) {
+		Log::warn("Compute shaders cannot write packed vertices, generating on the worker instead");
+		compute = false;
 	}
-}
+#else
+	if (compute) {
+		Log::warn("Compute shaders need the USE_OPENGL_4_6 build, generating on the worker instead");
+		compute = false;
+	}
+#endif
 
-/*
-* Creates vertices and colours for Levy C Curve and adds them to the vertex and colour vectors
-*
-* @param line	Line from previous iteration
-* @param iteration	Number of iterations to generate
-* @param totalIterations	Number of iterations to be generated in total
-* @param cpuGeom	Collection of vectors for geometry
-*
-*/
-void levyCCurveCreate(LevyCCurve line, int iteration, int totalIterations, CPU_Geometry& cpuGeom) {
-	if (iteration > 0) {
-
-		// Get size of lines
-		float lengthX = line.B.x - line.A.x;
-		float lengthY = line.B.y - line.A.y;
-		// Add size of lines to point A
-		float newX = line.A.x + (lengthX / 2) - (lengthY / 2);
-		float newY = line.A.y + (lengthY / 2) + (lengthX / 2);
-		glm::vec3 C(newX, newY, 0.f); // Create new vertex C 
-		
+	// The other paths neither cull to the view nor move with the camera, they would generate the whole
+	// figure down to the depth the camera allows
+	if (cameraEnabled && (procedural || pixel || mapped || streaming || feedback || compute)) {
+		Log::warn("The camera only works with the worker, ignoring --procedural, --pixel, --mapped, --streaming, --feedback and --compute");
+		procedural = pixel = mapped = streaming = feedback = compute = false;
+	}
 
-		// Normalize iteration range so that each iteration has a value between 0 and 1
-		float colourMidpoint = (static_cast<float>(totalIterations) - iteration) / totalIterations; // Cast to avoid improper truncate
+	// WINDOW
+	glfwInit();//MUST call this first to set up environment (There is a terminate pair after the loop)
+	Window window(800, 800, "CPSC 453 Assignment 1: Fractals"); // Can set callbacks at construction if desired
 
-		// Mix blue and green using colourMidpoint interpolant
-		glm::vec3 colourC = glm::mix(line.colourA, line.colourB, colourMidpoint);
+	//GLDebug::enable(); // ON Submission you may comments this out to avoid unnecessary prints to the console
+
+	// Time the generators against each other instead of showing anything
+	if (cmdl["benchmark"]) {
+		int repetitions = 5;
+		cmdl("repetitions", 5) >> repetitions;
+		// The GPU generators cannot write packed vertices, so those are benchmarked as separate ones
+		runGenerationBenchmark(generatorType, (format.layout == VertexLayout::Packed) ? VertexLayout::Separate : format.layout, repetitions);
+		glfwTerminate();
+		return 0;
+	}
 
-		// Create two new lines meeting at vertex C
-		LevyCCurve leftLine(line.A, C, line.colourA, colourC);
-		LevyCCurve rightLine(C, line.B, colourC, line.colourB);
+	// SHADERS
+	// Each scene draws its plain vertices with its own shaders (see SceneResources), these are for the other outputs
+	ShaderProgram instancedShader(
+		AssetPath::Instance()->Get("shaders/instanced.vert"),
+		AssetPath::Instance()->Get("shaders/basic.frag")
+	); // Adds a per instance offset to the shared shape
+	ShaderProgram hierarchyShader(
+		AssetPath::Instance()->Get("shaders/hierarchy.vert"),
+		AssetPath::Instance()->Get("shaders/basic.frag")
+	); // Maps the base line onto each instance
+	ShaderProgram flatShader(
+		AssetPath::Instance()->Get("shaders/flat.vert"),
+		AssetPath::Instance()->Get("shaders/flat.frag")
+	); // Colours each primitive with its provoking vertex
+	ShaderProgram codedShader(
+		AssetPath::Instance()->Get("shaders/coded.vert"),
+		AssetPath::Instance()->Get("shaders/basic.frag")
+	); // Works out each colour from the code of its vertex
 
-		levyCCurveCreate(leftLine, iteration - 1,totalIterations, cpuGeom);
-		levyCCurveCreate(rightLine, iteration - 1, totalIterations, cpuGeom);
+	std::unique_ptr<ColourMap> colourMap;
+	if (!colourMapName.empty()) {
+		try {
+			colourMap = std::make_unique<ColourMap>(colourMapName);
+		}
+		catch (const std::runtime_error&) {
+			Log::warn("Unknown colour map '{}', using the scene colours", colourMapName);
+		}
 	}
+	codedShader.use();
+	glUniform1i(glGetUniformLocation(codedShader, "useColourMap"), colourMap != nullptr);
+	glUniform1i(glGetUniformLocation(codedShader, "colourMap"), 0);
 
-	else {
-		// Add vertices to vertice vector
-		cpuGeom.verts.push_back(line.A); // Left point
-		cpuGeom.verts.push_back(line.B); // Right point
+	// CALLBACKS
+	int iteration = 0;
+	int sceneNumber = 0;
+	int maxIterations = 10;
+	
+	Camera camera;
+	std::shared_ptr<MyCallbacks> Callback_ptr = std::make_shared<MyCallbacks>(iteration, sceneNumber, maxIterations, cameraEnabled ? &camera : nullptr, window.getSize()); // Class To capture input events
+	window.setCallbacks(Callback_ptr); // Can also update callbacks to new ones as needed (create more than one instance)
 
-		// Add colours to colour vector
-		cpuGeom.cols.push_back(glm::vec3(line.colourA));
-		cpuGeom.cols.push_back(glm::vec3(line.colourB));
+	// GEOMETRY
+	std::vector<SceneResources> scenes; // Wrappers managing VAO and VBOs, in a TIGHTLY packed format
+	//https://www.khronos.org/opengl/wiki/Vertex_Specification_Best_Practices#Attribute_sizes
+	scenes.reserve(SCENE_COUNT);
+	for (int scene = 0; scene < SCENE_COUNT; scene++) {
+		scenes.emplace_back(fractalScene(scene), format.layout, procedural, pixel);
+	}
+	int shownScene = 0; // Whose shaders (and geometry, for plain vertices and pyramids) are drawn with
+	GPU_InstancedGeometry instancedGeom; // Shape and instances, for instanced results
+	GPU_HierarchyGeometry hierarchyGeom; // Base line, for hierarchical results
+	GPU_IndexedGeometry indexedGeom; // Shared vertices and triangles, for mesh results
+	GPU_CodedGeometry codedGeom; // Positions and colour codes, for coded results
+	GPU_ProceduralGeometry proceduralGeom; // No vertex data at all, for procedural and per pixel scenes
+	GPU_MappedGeometry mappedGeom(format.layout); // Ring of mapped VBO(s), for --mapped
+	GPU_Geometry streamedGeom(VertexLayout::Interleaved); // The whole figure, for --streaming
+	std::unique_ptr<GeometryCache> cache; // Results of the worker, pyramids already keep every iteration
+	if (cacheMegabytes > 0 && !format.pyramid && !mapped && !streaming && !feedback && !compute) {
+		cache = std::make_unique<GeometryCache>(format.layout, cacheMegabytes << 20);
+	}
+	GPU_Geometry* cachedGeom = nullptr; // GPU copy of the cache entry showing
+	GeneratedGeometry prefetched; // Last prefetch taken from the worker, it is copied into the cache
+	VertexChunk chunk; // Last chunk uploaded into streamedGeom, its vector goes back to the worker
+	std::unique_ptr<FeedbackGenerator> feedbackGenerator; // Writes into the gpuGeom of the scene
+	if (feedback) {
+		feedbackGenerator = std::make_unique<FeedbackGenerator>(format.layout);
+	}
+#ifdef USE_OPENGL_4_6
+	std::unique_ptr<ComputeGenerator> computeGenerator; // Writes into the gpuGeom of the scene
+	if (compute) {
+		computeGenerator = std::make_unique<ComputeGenerator>(format.layout);
+	}
+#endif
+
+	// Fractals are generated on a worker thread so deep iterations never block input or drawing.
+	// Posting an empty event wakes the render loop up when a result is ready
+	GenerationWorker generator([]() { glfwPostEmptyEvent(); }, generatorType, format);
+	std::unique_ptr<StreamingWorker> streamer;
+	if (streaming) {
+		streamer = std::make_unique<StreamingWorker>([]() { glfwPostEmptyEvent(); });
 	}
 
-}
 
-/*
-* Creates vertices and colours for Tree scene and adds them to the vertex and colour vectors
-*
-* @param branch		branch (or leaf) from previous iteration
-* @param iteration	Number of iterations to generate
-* @param iterationCounter	tracks number of iterations completed to detect when to start creating leaves
-* @param cpuGeom	Collection of vectors for geometry
-*
-*/
-void treeCreate(Tree branch, int iteration, int iterationCounter, CPU_Geometry& cpuGeom) {
-	glm::vec3 colour;
-	if (iteration > 0) {
-		iterationCounter++;
-
-		// Change to colour to leaf colour if past iteration 3
-		if (iterationCounter > 3) {
-			glm::vec3 leaves(0.1f, 0.4f, 0.f);
-			colour = leaves;
-		}
-		else (colour = branch.colour);
-
-		// Make new branch 1/2 the size of the previous
-		float lengthX = (branch.top.x - branch.base.x)/2;
-		float lengthY = (branch.top.y - branch.base.y)/2;
-
-		glm::vec3 topTip(branch.top.x + lengthX, branch.top.y + lengthY, 0.f); // Vertice of the tip of the top branch
-		glm::vec3 topConnect(branch.top); // Vertice that connects top branch to tree
-		Tree topBranch(topConnect, topTip, colour); // Create top branch
-		treeCreate(topBranch, iteration - 1, iterationCounter, cpuGeom);
+	// RENDER LOOP
+	// Geometry is only requested when the callbacks report a new state version, only uploaded
+	// when the worker publishes it, and the window is only redrawn when that happens or the
+	// window gets damaged. Between those the loop sleeps in glfwWaitEvents, so an idle viewer uses no CPU.
+	unsigned int requestedVersion = Callback_ptr->getStateVersion() - 1; // Force the first request
+	GLenum primitive = GL_TRIANGLES;
+	GLint firstVertex = 0; // Only the pyramids draw from anywhere but the start
+	GLsizei vertexCount = 0;
+	GLsizei instanceCount = 0;
+	DrawPath drawPath = DrawPath::Arrays;
+	bool onWorker = false; // Whether the current state is being generated on the worker
+	bool onStream = false; // Or streamed from the streamer
+	bool onMapped = false; // Or written into mappedGeom on the worker
+	bool mappedOut = false; // Whether a slot of mappedGeom is mapped for the worker to write into
+	glm::dvec2 shownOrigin(0.0); // What the positions of the geometry showing are relative to
+	FractalRequest wanted; // The current state
+
+	// Shows generated geometry, from the GPU copy of its cache entry if it has one
+	auto showGenerated = [&](const GeneratedGeometry& generated, CachedGeometry* cached) {
+		shownScene = generated.request.sceneNumber;
+		primitive = generated.primitive;
+		shownOrigin = generated.request.view.origin;
+		drawPath = drawPathFor(generated.cpuGeom);
+		if (drawPath == DrawPath::Hierarchy) {
+			hierarchyGeom.upload(generated.cpuGeom, hierarchyShader); // Upload the base line and the steps
+		}
+		else if (drawPath == DrawPath::Instanced) {
+			instancedGeom.upload(generated.cpuGeom); // Upload the shape and the instances
+			vertexCount = GLsizei(generated.cpuGeom.verts.size());
+			instanceCount = GLsizei(generated.cpuGeom.instances.size());
+		}
+		else if (drawPath == DrawPath::Indexed) {
+			indexedGeom.upload(generated.cpuGeom); // Upload the shared vertices and the triangles
+		}
+		else if (drawPath == DrawPath::Coded) {
+			codedGeom.upload(generated.cpuGeom, codedShader); // Upload the coded vertices and the colour table
+			vertexCount = GLsizei(generated.cpuGeom.codedVertices.size());
+		}
+		else if (drawPath == DrawPath::Pyramid) {
+			// Uploaded as soon as it arrived
+			LevelRange level = scenes[shownScene].pyramid.level(std::min(iteration, scenes[shownScene].pyramid.levelCount() - 1));
+			firstVertex = level.first;
+			vertexCount = level.count;
+		}
+		else if (cached && cached->gpuGeom) {
+			cachedGeom = &*cached->gpuGeom; // Uploaded when it was cached
+			vertexCount = GLsizei(countVertices(generated.cpuGeom, format.layout));
+			drawPath = DrawPath::Cached;
+		}
+		else {
+			SceneResources& resources = scenes[shownScene];
+			resources.gpuGeom.upload(generated.cpuGeom); // Upload vertex positions and colours to the VBO(s)
+			resources.vertexCount = GLsizei(countVertices(generated.cpuGeom, format.layout));
+			resources.resident = generated.request;
+			vertexCount = resources.vertexCount;
+		}
+		if (cache) {
+			cache->pin((drawPath == DrawPath::Cached) ? cached : nullptr);
+		}
+		Callback_ptr->markDamaged();
+	};
+
+	// Has the worker generate whatever is one input away from the current state while it is idle
+	auto prefetchNeighbours = [&]() {
+		std::vector<FractalRequest> prefetches;
+		for (const FractalRequest& next : neighbouringRequests(wanted, maxIterations, cameraEnabled)) {
+			bool drawnStraightAway = scenes[next.sceneNumber].pixelShader || scenes[next.sceneNumber].proceduralShader
+				|| scenes[next.sceneNumber].resident == next;
+			if (!drawnStraightAway && !cache->contains(next)) {
+				prefetches.push_back(next);
+			}
+		}
+		generator.prefetch(prefetches);
+	};
 
-		
-		glm::vec3 midpoint((branch.base + branch.top) * .5f); // connecting point to trunk
-		glm::vec dirVec(branch.top - branch.base); // direction vector
+	// Maps the next slot of mappedGeom, only on this thread, and has the worker write request into it
+	auto writeMapped = [&](const FractalRequest& request) {
+		generator.requestInto(request, mappedGeom.map(fractalVertexCount(request)));
+		mappedOut = true;
+	};
 
-		// Make new branch 1/2 the size of the previous and rotated +25.7 degrees (left)
-		glm::mat4 rotate(glm::rotate(glm::mat4(1.0f), glm::radians(25.7f), glm::vec3(0.f, 0.f, 1.f))); // rotation matrix
-		glm::vec3 leftBranchTip(glm::vec3(rotate * glm::vec4(dirVec, 1.f)) * 0.5f); // left branch rotated and half the length of previous branch
-		leftBranchTip += midpoint; // translate to middle of previous branch
+	while (!window.shouldClose()) {
+		// Keep whatever the worker prefetched while idle for when it is asked for
+		while (cache && generator.acquirePrefetched(prefetched)) {
+			cache->insert(prefetched, drawPathFor(prefetched.cpuGeom) == DrawPath::Arrays);
+		}
 
-		Tree leftBranch(midpoint, leftBranchTip, colour);
-		treeCreate(leftBranch, iteration - 1, iterationCounter, cpuGeom);
+		// All input since the last pass has been applied by now, so a burst of events
+		// (e.g. fast scrolling) only produces a single request for the final state
+		if (Callback_ptr->getStateVersion() != requestedVersion) {
+			requestedVersion = Callback_ptr->getStateVersion();
 
+			// Prevent from generating a higher number of iterations than allowed
+			bool perPixel = scenes[sceneNumber].pixelShader.has_value();
+			if (perPixel) {
+				maxIterations = PIXEL_MAX_ITERATIONS;
+			}
+			else if (cameraEnabled) {
+				maxIterations = MAX_FRACTAL_DEPTH; // Deeper than any view needs, the pixels decide
+			}
+			else {
+				maxIterations = fractalMaxIterations(sceneNumber);
+			}
+			if (iteration > maxIterations) {
+				iteration = maxIterations;
+			}
 
-		// Make new branch 1/2 the size of the previous and rotated -25.7 degrees (right)
-		rotate = (glm::rotate(glm::mat4(1.0f), glm::radians(-25.7f), glm::vec3(0.f, 0.f, 1.f))); // rotation matrix
-		glm::vec3 rightBranchTip(glm::vec3(rotate * glm::vec4(dirVec, 1.f)) * 0.5f); // right branch rotated and half the length of previous branch
-		rightBranchTip += midpoint; // translate to midpoint of previous branch
+			// Per pixel and procedural scenes are drawn straight away, as are scenes whose vertices are
+			// still resident. The others are generated on the GPU, straight into mapped buffers or on the worker
+			FractalRequest request{ sceneNumber, iteration };
+			if (cameraEnabled) {
+				request.view = camera.view(Callback_ptr->getWindowSize());
+			}
+			wanted = request;
+			onWorker = false;
+			onStream = false;
+			onMapped = false;
+			if (mappedOut) {
+				generator.cancel(); // The slot comes back unfinished, and is written again if needed
+			}
+			bool fromCache = false;
+			if (perPixel) {
+				shownScene = sceneNumber;
+				setPixelUniforms(iteration, *scenes[sceneNumber].pixelShader);
+				drawPath = DrawPath::Pixel;
+				Callback_ptr->markDamaged();
+			}
+			else if (scenes[sceneNumber].proceduralShader) {
+				shownScene = sceneNumber;
+				setProceduralUniforms(request, *scenes[sceneNumber].proceduralShader);
+				primitive = fractalPrimitive(sceneNumber);
+				vertexCount = proceduralVertexCount(request);
+				drawPath = DrawPath::Procedural;
+				Callback_ptr->markDamaged();
+			}
+			else if (scenes[sceneNumber].resident == request) {
+				shownScene = sceneNumber; // Shown before and not overwritten since, only the binding changes
+				primitive = fractalPrimitive(sceneNumber);
+				vertexCount = scenes[sceneNumber].vertexCount;
+				drawPath = DrawPath::Arrays;
+				fromCache = true;
+				if (cache) {
+					cache->pin(nullptr);
+					prefetchNeighbours();
+				}
+				Callback_ptr->markDamaged();
+			}
+#ifdef USE_OPENGL_4_6
+			else if (computeGenerator) {
+				shownScene = sceneNumber;
+				scenes[sceneNumber].resident.reset(); // The vertex count is only in the indirect buffer
+				computeGenerator->generate(request, scenes[sceneNumber].gpuGeom); // Subdivide straight into the VBO(s)
+				primitive = fractalPrimitive(sceneNumber);
+				drawPath = DrawPath::Indirect;
+				Callback_ptr->markDamaged();
+			}
+#endif
+			else if (feedbackGenerator) {
+				shownScene = sceneNumber;
+				SceneResources& resources = scenes[sceneNumber];
+				resources.vertexCount = feedbackGenerator->generate(request, resources.gpuGeom); // Subdivide straight into the VBO(s)
+				resources.resident = request;
+				vertexCount = resources.vertexCount;
+				primitive = fractalPrimitive(sceneNumber);
+				drawPath = DrawPath::Arrays;
+				Callback_ptr->markDamaged();
+			}
+			else if (mapped) {
+				// Only one slot is out at a time, so a slot still being written is written again once it is back
+				if (!mappedOut) {
+					writeMapped(request);
+				}
+				onMapped = true;
+				if (drawPath == DrawPath::Procedural || drawPath == DrawPath::Pixel) {
+					drawPath = DrawPath::Mapped; // Nothing to draw until the slot is written
+					vertexCount = 0;
+				}
+			}
+			else if (streamer) {
+				shownScene = sceneNumber;
+				streamer->request(request);
+				streamedGeom.reserve(fractalVertexCount(request)); // The closed form size, so it never has to grow
+				primitive = fractalPrimitive(sceneNumber);
+				vertexCount = 0; // Grows as the chunks arrive
+				drawPath = DrawPath::Streamed;
+				onStream = true;
+				Callback_ptr->markDamaged();
+			}
+			else if (format.pyramid && iteration < scenes[sceneNumber].pyramid.levelCount()) {
+				LevelRange level = scenes[sceneNumber].pyramid.level(iteration); // Already resident, only the range drawn changes
+				shownScene = sceneNumber;
+				firstVertex = level.first;
+				vertexCount = level.count;
+				primitive = fractalPrimitive(sceneNumber);
+				drawPath = DrawPath::Pyramid;
+				Callback_ptr->markDamaged();
+			}
+			else if (CachedGeometry* cached = cache ? cache->find(request) : nullptr) {
+				showGenerated(cached->generated, cached); // Generated before, so there is nothing to wait for
+				fromCache = true;
+				prefetchNeighbours();
+			}
+			else {
+				if (format.pyramid) {
+					request.iteration = fractalMaxIterations(sceneNumber); // Every iteration at once
+				}
+				generator.request(request);
+				onWorker = true;
+				if (drawPath == DrawPath::Procedural || drawPath == DrawPath::Pixel) {
+					drawPath = DrawPath::Arrays; // Nothing to draw until the result arrives
+					vertexCount = 0;
+				}
+			}
+			if (!onWorker && !fromCache) {
+				shownOrigin = glm::dvec2(0.0); // Only the culled results of the worker are relative to their view
+			}
+		}
 
-		Tree rightBranch(midpoint, rightBranchTip, colour);
-		treeCreate(rightBranch, iteration - 1, iterationCounter, cpuGeom);
+		// Swap in the newest finished geometry without waiting on the worker. A result of a
+		// scene left before it finished is only kept for when it is shown again, as a pyramid or
+		// in the cache
+		bool acquired = generator.acquire();
+		if (acquired && generator.latest().cpuGeom.kind == GeometryKind::Levels) {
+			const GeneratedGeometry& latest = generator.latest();
+			scenes[latest.request.sceneNumber].pyramid.upload(latest.cpuGeom); // Upload every iteration to the VBO(s)
+		}
+		if (acquired && (onWorker || cache)) {
+			const GeneratedGeometry& latest = generator.latest();
+			CachedGeometry* cached = cache ? cache->insert(latest, drawPathFor(latest.cpuGeom) == DrawPath::Arrays) : nullptr;
+			if (onWorker) {
+				showGenerated(latest, cached);
+			}
+			// The worker is idle once it has caught up with the current state
+			if (cache && latest.request == wanted) {
+				prefetchNeighbours();
+			}
+		}
 
-	}
-	
+		// Take back the slot the worker wrote into. It is shown if it holds the current state, otherwise
+		// the current state is written into the next one. The driver may lose what was written into a
+		// map, then it is written again too
+		FractalRequest written;
+		bool finished = false;
+		if (mapped && generator.acquireWritten(written, finished)) {
+			mappedOut = false;
+			if (finished && onMapped && written == wanted) {
+				if (mappedGeom.unmap()) {
+					shownScene = written.sceneNumber;
+					primitive = fractalPrimitive(written.sceneNumber);
+					vertexCount = GLsizei(fractalVertexCount(written));
+					drawPath = DrawPath::Mapped;
+					Callback_ptr->markDamaged();
+				}
+				else {
+					vertexCount = 0; // The slot is current, but its vertices are gone
+					writeMapped(wanted);
+				}
+			}
+			else {
+				mappedGeom.abandon();
+				if (onMapped) {
+					writeMapped(wanted);
+				}
+			}
+		}
 
-	// Add vertices to vertice vector
-	cpuGeom.verts.push_back(branch.base); // Left point
-	cpuGeom.verts.push_back(branch.top); // Right point
+		// Upload the chunks streamed since the last pass. The figure is drawn as far as it has
+		// arrived, an unfinished primitive at the end of a chunk is skipped until the next one
+		while (streamer && streamer->acquire(chunk)) {
+			if (onStream) {
+				streamedGeom.updateVertices(chunk.firstVertex, chunk.vertices);
+				vertexCount = GLsizei(chunk.firstVertex + chunk.vertices.size());
+				Callback_ptr->markDamaged();
+			}
+		}
 
-	// Add colours to colour vector
-	cpuGeom.cols.push_back(glm::vec3(branch.colour));
-	cpuGeom.cols.push_back(glm::vec3(branch.colour));
+		// Only redraw when something changed
+		if (Callback_ptr->consumeDamage()) {
+			glEnable(GL_FRAMEBUFFER_SRGB); // Expect Colour to be encoded in sRGB standard (as opposed to RGB) 
+			// https://www.viewsonic.com/library/creative-work/srgb-vs-adobe-rgb-which-one-to-use/
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Clear render screen (all zero) and depth (all max depth)
+			SceneResources& shown = scenes[shownScene];
+			if (cameraEnabled) {
+				camera.setUniforms(shown.shader, shownOrigin); // Moves the last geometry along until the new one arrives
+			}
+
+			if (drawPath == DrawPath::Hierarchy) {
+				hierarchyShader.use();
+				hierarchyGeom.bind();
+				hierarchyGeom.draw(hierarchyShader); // Render the base line once per line of the figure
+			}
+			else if (drawPath == DrawPath::Instanced) {
+				instancedShader.use();
+				instancedGeom.bind();
+				glDrawArraysInstanced(primitive, 0, vertexCount, instanceCount); // Render one shape per instance
+			}
+			else if (drawPath == DrawPath::Indexed) {
+				flatShader.use();
+				indexedGeom.bind();
+				glEnable(GL_PRIMITIVE_RESTART); // Separates line strips
+				glPrimitiveRestartIndex(indexedGeom.getRestartIndex());
+				glDrawElements(primitive, indexedGeom.getIndexCount(), indexedGeom.getIndexType(), nullptr); // Render the primitives
+				glDisable(GL_PRIMITIVE_RESTART);
+			}
+#ifdef USE_OPENGL_4_6
+			else if (drawPath == DrawPath::Indirect) {
+				shown.shader.use();
+				shown.gpuGeom.bind();
+				computeGenerator->draw(primitive); // Render as many vertices as the GPU wrote
+			}
+#endif
+			else if (drawPath == DrawPath::Procedural) {
+				shown.proceduralShader->use();
+				proceduralGeom.bind();
+				glDrawArrays(primitive, 0, vertexCount); // Render primitives made up from their index
+			}
+			else if (drawPath == DrawPath::Mapped) {
+				shown.shader.use();
+				mappedGeom.bind();
+				glDrawArrays(primitive, 0, vertexCount); // Render primitives
+				mappedGeom.fence(); // The slot can be written again once the GPU passes this
+			}
+			else if (drawPath == DrawPath::Streamed) {
+				shown.shader.use();
+				streamedGeom.bind();
+				glDrawArrays(primitive, 0, vertexCount); // Render what has been streamed so far
+			}
+			else if (drawPath == DrawPath::Cached) {
+				shown.shader.use();
+				cachedGeom->bind();
+				glDrawArrays(primitive, 0, vertexCount); // Render primitives
+			}
+			else if (drawPath == DrawPath::Pyramid) {
+				shown.shader.use();
+				shown.pyramid.bind();
+				glDrawArrays(primitive, firstVertex, vertexCount); // Render the level of the current iteration
+			}
+			else if (drawPath == DrawPath::Pixel) {
+				shown.pixelShader->use();
+				proceduralGeom.bind();
+				glDrawArrays(GL_TRIANGLES, 0, 3); // Render the full screen triangle
+			}
+			else if (drawPath == DrawPath::Coded) {
+				codedShader.use();
+				codedGeom.bind();
+				if (colourMap) {
+					colourMap->bind();
+				}
+				glDrawArrays(primitive, 0, vertexCount); // Render primitives
+			}
+			else {
+				shown.shader.use(); // Use "this" shader to render
+				shown.gpuGeom.bind(); // USe "this" VAO (Geometry) on render call
+				glDrawArrays(primitive, 0, vertexCount); // Render primitives
+			}
+			glDisable(GL_FRAMEBUFFER_SRGB); // disable sRGB for things like imgui (if used)
+
+			window.swapBuffers(); //Swap the buffers while displaying the previous 	
+		}
 
-}
\ No newline at end of file
+		glfwWaitEvents(); // Sleep until an event arrives, then propagate it to the callback class
+	}
+
+	generator.stop(); // The workers post GLFW events, so stop them before terminating
+	if (streamer) {
+		streamer->stop();
+	}
+	glfwTerminate(); // Clean up GLFW
+	return 0;
+}
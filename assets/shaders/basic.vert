@@ -2,9 +2,12 @@
 layout (location = 0) in vec3 pos;
 layout (location = 1) in vec3 color;
 
+uniform vec2 viewCentre = vec2(0.0); // Camera (see Camera.h) relative to the origin of the vertices, shows everything unless --camera is set
+uniform float viewScale = 1.0;
+
 out vec3 fragColor;
 
 void main() {
-	gl_Position = vec4(pos, 1.0);
+	gl_Position = vec4((pos.xy - viewCentre) * viewScale, pos.z, 1.0);
 	fragColor = color;
 }
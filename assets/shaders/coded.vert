@@ -0,0 +1,59 @@
+#version 330 core
+layout (location = 0) in vec2 pos;
+layout (location = 1) in uint code;
+
+out vec3 fragColor;
+
+const int MAX_STEPS = 40;
+const int PATH_BITS = 26; // COLOUR_CODE_PATH_BITS in Geometry.h
+
+uniform int branching; // Children per primitive
+uniform vec3 baseColours[2]; // Colour at each end of the initial primitive
+
+// One entry per level and child, [level * branching + child]
+uniform vec2 colourMix[MAX_STEPS];
+uniform vec3 colourOffset[MAX_STEPS];
+uniform vec4 colourOverride[MAX_STEPS];
+
+// Colours from a colour map instead, by position along the figure
+uniform bool useColourMap;
+uniform sampler1D colourMap;
+
+// The code holds the depth, the child taken at every level (as base branching digits, most
+// significant first) and the end of the line. Walking down those steps from the colours of
+// the initial primitive gives the colour the generators compute
+void main() {
+	int depth = int(code >> uint(PATH_BITS + 1));
+	int path = int((code >> 1u) & ((1u << uint(PATH_BITS)) - 1u));
+	int end = int(code & 1u);
+
+	int place = 1;
+	for (int level = 0; level < depth; level++) {
+		place *= branching;
+	}
+
+	if (useColourMap) {
+		fragColor = texture(colourMap, float(path + end) / float(place)).rgb;
+	}
+	else {
+		vec3 colourA = baseColours[0];
+		vec3 colourB = baseColours[1];
+		int remaining = path;
+
+		for (int level = 0; level < depth; level++) {
+			place /= branching;
+			int child = remaining / place;
+			remaining -= child * place;
+
+			int step = level * branching + child;
+			vec3 a = mix(colourA, colourB, colourMix[step].x) + colourOffset[step];
+			vec3 b = mix(colourA, colourB, colourMix[step].y) + colourOffset[step];
+			colourA = mix(a, colourOverride[step].rgb, colourOverride[step].a);
+			colourB = mix(b, colourOverride[step].rgb, colourOverride[step].a);
+		}
+
+		fragColor = (end == 0) ? colourA : colourB;
+	}
+
+	gl_Position = vec4(pos, 0.0, 1.0);
+}
@@ -0,0 +1,18 @@
+#version 330 core
+
+// One primitive per instance, laid out like the outputs of subdivide.vert
+layout (location = 0) in vec2 point0;
+layout (location = 1) in vec2 point1;
+layout (location = 2) in vec2 point2;
+layout (location = 3) in vec3 colour0;
+layout (location = 4) in vec3 colour1;
+
+// One vertex per corner (gl_VertexID), captured with transform feedback into a GPU_Geometry
+out vec3 position;
+out vec3 colour;
+
+void main() {
+	vec2 point = (gl_VertexID == 0) ? point0 : ((gl_VertexID == 1) ? point1 : point2);
+	position = vec3(point, 0.0);
+	colour = (gl_VertexID == 0) ? colour0 : colour1;
+}
@@ -0,0 +1,10 @@
+#version 330 core
+
+out vec2 position; // Normalized device coordinates of the fragment
+
+// One triangle covering the whole screen, made up from gl_VertexID (0, 1, 2)
+void main() {
+	vec2 corner = vec2(float((gl_VertexID & 1) << 2) - 1.0, float((gl_VertexID & 2) << 1) - 1.0);
+	position = corner;
+	gl_Position = vec4(corner, 0.0, 1.0);
+}
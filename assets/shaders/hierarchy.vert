@@ -0,0 +1,46 @@
+#version 330 core
+layout (location = 0) in vec3 pos;
+
+out vec3 fragColor;
+
+const int MAX_STEPS = 40;
+
+uniform int depth; // Level being drawn
+uniform int branching; // Children per line
+uniform vec3 baseColours[2]; // Colour at each end of the base line
+
+// One entry per level and child, [level * branching + child]
+uniform mat3 transforms[MAX_STEPS];
+uniform vec2 colourMix[MAX_STEPS];
+uniform vec3 colourOffset[MAX_STEPS];
+uniform vec4 colourOverride[MAX_STEPS];
+
+// The instance ID spells out which child was taken at every level, most significant digit
+// first. Walking down those steps maps the base line onto this instance
+void main() {
+	int place = 1;
+	for (int level = 1; level < depth; level++) {
+		place *= branching;
+	}
+
+	mat3 frame = mat3(1.0);
+	vec3 colourA = baseColours[0];
+	vec3 colourB = baseColours[1];
+	int remaining = gl_InstanceID;
+
+	for (int level = 0; level < depth; level++) {
+		int child = remaining / place;
+		remaining -= child * place;
+		place /= branching;
+
+		int step = level * branching + child;
+		frame = frame * transforms[step];
+		vec3 a = mix(colourA, colourB, colourMix[step].x) + colourOffset[step];
+		vec3 b = mix(colourA, colourB, colourMix[step].y) + colourOffset[step];
+		colourA = mix(a, colourOverride[step].rgb, colourOverride[step].a);
+		colourB = mix(b, colourOverride[step].rgb, colourOverride[step].a);
+	}
+
+	gl_Position = vec4((frame * vec3(pos.xy, 1.0)).xy, 0.0, 1.0);
+	fragColor = (gl_VertexID == 0) ? colourA : colourB;
+}
@@ -0,0 +1,12 @@
+#version 330 core
+layout (location = 0) in vec3 pos;
+layout (location = 1) in vec3 color;
+layout (location = 2) in vec2 offset;
+
+out vec3 fragColor;
+
+// pos comes from the shared shape, color and offset from the instance
+void main() {
+	gl_Position = vec4(pos + vec3(offset, 0.0), 1.0);
+	fragColor = color;
+}
@@ -0,0 +1,98 @@
+#version 330 core
+
+out vec3 fragColor;
+
+uniform int scene; // 0 for the Sierpinski Triangle, 1 for the Levy C Curve
+uniform int iteration;
+uniform vec2 rootPositions[3]; // Corners of the initial triangle, or ends of the initial line
+uniform vec3 rootColours[2]; // Colour of the initial triangle, or colours at the ends of the initial line
+
+// Vertex k belongs to primitive k / 3 (or k / 2), and the base 3 (or base 2) digits of that
+// primitive, most significant first, are the children the recursive generators take to reach
+// it. Following them with the same steps as SierpinskiTriangle::subdivide and
+// LevyCCurve::subdivide gives the position and colour without any vertex data
+
+void sierpinski() {
+	int triangle = gl_VertexID / 3;
+	int corner = gl_VertexID - 3 * triangle;
+
+	int place = 1;
+	for (int level = 0; level < iteration; level++) {
+		place *= 3;
+	}
+
+	vec2 A = rootPositions[0];
+	vec2 B = rootPositions[1];
+	vec2 C = rootPositions[2];
+	vec3 colour = rootColours[0];
+	int remaining = triangle;
+
+	for (int level = 0; level < iteration; level++) {
+		place /= 3;
+		int child = remaining / place;
+		remaining -= child * place;
+
+		vec2 D = 0.5 * (A + C);
+		vec2 E = 0.5 * (C + B);
+		vec2 F = 0.5 * (B + A);
+		float increment = (float(iteration - level) / float(iteration)) * 0.33;
+
+		if (child == 0) { // Top
+			A = D; B = E;
+			colour.y -= increment;
+		}
+		else if (child == 1) { // Left
+			A = F; C = E;
+			colour.z += increment;
+		}
+		else { // Right
+			B = F; C = D;
+			colour.z -= increment;
+		}
+	}
+
+	vec2 position = (corner == 0) ? A : ((corner == 1) ? B : C);
+	gl_Position = vec4(position, 0.0, 1.0);
+	fragColor = colour;
+}
+
+void levy() {
+	int line = gl_VertexID / 2;
+	int end = gl_VertexID - 2 * line;
+	int totalIterations = iteration * 2; // As in generateFractal
+
+	vec2 A = rootPositions[0];
+	vec2 B = rootPositions[1];
+	vec3 colourA = rootColours[0];
+	vec3 colourB = rootColours[1];
+
+	for (int level = 0; level < iteration; level++) {
+		int child = (line >> (iteration - level - 1)) & 1;
+
+		vec2 along = B - A;
+		vec2 C = A + 0.5 * along + 0.5 * vec2(-along.y, along.x);
+		float colourMidpoint = float(totalIterations - (iteration - level)) / float(totalIterations);
+		vec3 colourC = mix(colourA, colourB, colourMidpoint);
+
+		if (child == 0) { // Left
+			B = C;
+			colourB = colourC;
+		}
+		else { // Right
+			A = C;
+			colourA = colourC;
+		}
+	}
+
+	gl_Position = vec4((end == 0) ? A : B, 0.0, 1.0);
+	fragColor = (end == 0) ? colourA : colourB;
+}
+
+void main() {
+	if (scene == 0) {
+		sierpinski();
+	}
+	else {
+		levy();
+	}
+}
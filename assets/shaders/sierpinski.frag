@@ -0,0 +1,46 @@
+#version 330 core
+out vec4 color;
+
+in vec2 position;
+
+uniform int iteration;
+uniform vec2 corners[3]; // A (lower left), B (lower right) and C (upper) of the initial triangle
+uniform vec3 baseColour; // Colour of the initial triangle
+
+// Writing the fragment as A + s (B - A) + t (C - A) and scaling s and t by 2^iteration puts it
+// in lattice cell (i, j). The cell is part of the figure when the bits of i and j never overlap
+// (Pascal's triangle mod 2), and the fragment is in its upward half. Each bit pair, most
+// significant first, is the child SierpinskiTriangle::subdivide takes at that level, which also
+// gives the colour. So the cost only depends on the number of fragments
+void main() {
+	mat2 frame = mat2(corners[1] - corners[0], corners[2] - corners[0]);
+	vec2 st = inverse(frame) * (position - corners[0]);
+	if (st.x < 0.0 || st.y < 0.0 || st.x + st.y > 1.0) {
+		discard;
+	}
+
+	float size = exp2(float(iteration));
+	vec2 lattice = st * size;
+	uvec2 cell = uvec2(min(floor(lattice), vec2(size - 1.0)));
+	vec2 inCell = lattice - vec2(cell);
+	if ((cell.x & cell.y) != 0u || inCell.x + inCell.y >= 1.0) {
+		discard;
+	}
+
+	vec3 colour = baseColour;
+	for (int level = 0; level < iteration; level++) {
+		int bit = iteration - level - 1;
+		float increment = (float(iteration - level) / float(iteration)) * 0.33;
+		if (((cell.y >> uint(bit)) & 1u) != 0u) { // Top, towards C
+			colour.y -= increment;
+		}
+		else if (((cell.x >> uint(bit)) & 1u) != 0u) { // Left, towards B
+			colour.z += increment;
+		}
+		else { // Right, towards A
+			colour.z -= increment;
+		}
+	}
+
+	color = vec4(colour, 1.0);
+}
@@ -0,0 +1,104 @@
+#version 330 core
+
+// One primitive of the current level per instance: the corners of a triangle (or the ends of a
+// line in the first two) and the colours at the two ends (the same for triangles and branches)
+layout (location = 0) in vec2 parentPoint0;
+layout (location = 1) in vec2 parentPoint1;
+layout (location = 2) in vec2 parentPoint2;
+layout (location = 3) in vec3 parentColour0;
+layout (location = 4) in vec3 parentColour1;
+
+// One child per vertex, captured with transform feedback in the same layout
+out vec2 point0;
+out vec2 point1;
+out vec2 point2;
+out vec3 colour0;
+out vec3 colour1;
+
+uniform int scene; // 0 for the Sierpinski Triangle, 1 for the Levy C Curve, 2 for the Tree
+uniform int iteration; // Iterations left, as passed to subdivide
+uniform int totalIterations;
+uniform int iterationCounter; // As passed to Tree::grow
+uniform mat2 branchRotations[2]; // Left and right branch rotations of Tree::grow
+
+// gl_VertexID is the child, in the order of SierpinskiTriangle::subdivide, LevyCCurve::subdivide
+// and Tree::grow, so the children of primitive p land at branching * p + child and every level
+// stays in the order the recursive generators emit it
+
+void sierpinski(int child) {
+	vec2 A = parentPoint0;
+	vec2 B = parentPoint1;
+	vec2 C = parentPoint2;
+	vec2 D = 0.5 * (A + C);
+	vec2 E = 0.5 * (C + B);
+	vec2 F = 0.5 * (B + A);
+
+	float increment = (float(iteration) / float(totalIterations)) * 0.33;
+	vec3 colour = parentColour0;
+
+	if (child == 0) { // Top
+		point0 = D; point1 = E; point2 = C;
+		colour.y -= increment;
+	}
+	else if (child == 1) { // Left
+		point0 = F; point1 = B; point2 = E;
+		colour.z += increment;
+	}
+	else { // Right
+		point0 = A; point1 = F; point2 = D;
+		colour.z -= increment;
+	}
+	colour0 = colour;
+	colour1 = colour;
+}
+
+void levy(int child) {
+	vec2 A = parentPoint0;
+	vec2 B = parentPoint1;
+	vec2 along = B - A;
+	vec2 C = A + 0.5 * along + 0.5 * vec2(-along.y, along.x);
+
+	float colourMidpoint = float(totalIterations - iteration) / float(totalIterations);
+	vec3 colourC = mix(parentColour0, parentColour1, colourMidpoint);
+
+	if (child == 0) { // Left
+		point0 = A; point1 = C;
+		colour0 = parentColour0; colour1 = colourC;
+	}
+	else { // Right
+		point0 = C; point1 = B;
+		colour0 = colourC; colour1 = parentColour1;
+	}
+	point2 = point1;
+}
+
+void tree(int child) {
+	vec2 base = parentPoint0;
+	vec2 top = parentPoint1;
+	vec2 midpoint = (base + top) * 0.5;
+	vec2 direction = top - base;
+
+	if (child == 0) { // Top
+		point0 = top; point1 = top + direction / 2.0;
+	}
+	else { // Left or right, rotated and half the length
+		point0 = midpoint; point1 = branchRotations[child - 1] * direction * 0.5 + midpoint;
+	}
+	point2 = point1;
+
+	// Leaf colour past iteration 3
+	colour0 = (iterationCounter > 3) ? vec3(0.1, 0.4, 0.0) : parentColour0;
+	colour1 = colour0;
+}
+
+void main() {
+	if (scene == 0) {
+		sierpinski(gl_VertexID);
+	}
+	else if (scene == 1) {
+		levy(gl_VertexID);
+	}
+	else {
+		tree(gl_VertexID);
+	}
+}